@@ -1,3 +1,3 @@
-#include "Colour.h"
-
+#include "Colour.h"
+
 Colour Colour::White(255,255,255,255);
\ No newline at end of file
@@ -1,36 +1,70 @@
-/******************************************************************************
-Author:Rich Davison
-Description: Some random variables and functions, for lack of a better place 
-to put them.
-
--_-_-_-_-_-_-_,------,   
-_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
--_-_-_-_-_-_-~|__( ^ .^) /
-_-_-_-_-_-_-_-""  ""   
-
-*//////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-//It's pi(ish)...
-static const float		PI = 3.14159265358979323846f;	
-
-//It's pi...divided by 360.0f!
-static const float		PI_OVER_360 = PI / 360.0f;
-
-//Radians to degrees
-static inline double RadToDeg(const double deg)	{
-	return deg * 180.0 / PI;
-};
-
-//Degrees to radians
-static inline double DegToRad(const double rad)	{
-	return rad * PI / 180.0;
-};
-
-//I blame Microsoft...
-#define max(a,b)    (((a) > (b)) ? (a) : (b))
-#define min(a,b)    (((a) < (b)) ? (a) : (b))
-#define clamp(a,b,c) (a < b ? b : (a > c ? c : a))
-
-typedef unsigned int uint;
\ No newline at end of file
+/******************************************************************************
+Author:Rich Davison
+Description: Some random variables and functions, for lack of a better place 
+to put them.
+
+-_-_-_-_-_-_-_,------,   
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""   
+
+*//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdlib>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+//It's pi(ish)...
+static const float		PI = 3.14159265358979323846f;	
+
+//It's pi...divided by 360.0f!
+static const float		PI_OVER_360 = PI / 360.0f;
+
+//Radians to degrees
+static inline double RadToDeg(const double deg)	{
+	return deg * 180.0 / PI;
+};
+
+//Degrees to radians
+static inline double DegToRad(const double rad)	{
+	return rad * PI / 180.0;
+};
+
+//I blame Microsoft...
+#define max(a,b)    (((a) > (b)) ? (a) : (b))
+#define min(a,b)    (((a) < (b)) ? (a) : (b))
+#define clamp(a,b,c) (a < b ? b : (a > c ? c : a))
+
+//Per thread variables - VS2013 doesn't know about thread_local yet
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL thread_local
+#endif
+
+typedef unsigned int uint;
+
+//Memory that starts on an 'alignment' byte boundary, so SIMD code can use
+//aligned loads. Must be freed with AlignedFree!
+static inline void* AlignedAlloc(size_t bytes, size_t alignment) {
+#ifdef _MSC_VER
+	return _aligned_malloc(bytes, alignment);
+#else
+	void* p = NULL;
+	if (posix_memalign(&p, alignment, bytes) != 0) {
+		return NULL;
+	}
+	return p;
+#endif
+}
+
+static inline void AlignedFree(void* p) {
+#ifdef _MSC_VER
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#include "DepthTarget.h"
+#include <cstring>
+
+DepthTarget::DepthTarget(uint width, uint height)	{
+	this->width		= max(1u, width);
+	this->height	= max(1u, height);
+
+	depth = new unsigned short[this->width * this->height];
+	Clear();
+}
+
+DepthTarget::~DepthTarget(void)	{
+	delete[] depth;
+}
+
+void DepthTarget::Clear() {
+	memset(depth, 0xFF, width * height * sizeof(unsigned short));
+}
@@ -0,0 +1,48 @@
+/******************************************************************************
+Class:DepthTarget
+Implements:
+Description:A depth buffer of its own, of whatever size you like, to draw into
+instead of the screen - shadow maps, mostly. Bind one with
+SoftwareRasteriser::SetDepthTarget, and everything drawn goes into it as depth
+only, with the viewport stretched to fit it.
+
+Depths are the same as the screen's: 0 at the near plane, up to 65535 at the
+far plane.
+
+-_-_-_-_-_-_-_,------,
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""
+
+*//////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Common.h"
+
+class DepthTarget	{
+	friend class SoftwareRasteriser;
+public:
+	DepthTarget(uint width, uint height);
+	~DepthTarget(void);
+
+	uint	GetWidth()	const { return width;}
+	uint	GetHeight() const { return height;}
+
+	//Everything back to as far away as it goes
+	void	Clear();
+
+	inline unsigned short GetDepth(uint x, uint y) const {
+		return depth[(y * width) + x];
+	}
+	const unsigned short*	GetData() const { return depth;}
+
+protected:
+	uint			width;
+	uint			height;
+	unsigned short*	depth;
+
+private:
+	//Owns its buffer, so can't be copied
+	DepthTarget(const DepthTarget &t);
+	DepthTarget& operator=(const DepthTarget &t);
+};
@@ -0,0 +1,99 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(void)	{
+	fileHandle		= NULL;
+	mappingHandle	= NULL;
+	data			= NULL;
+	size			= 0;
+}
+
+MappedFile::~MappedFile(void)	{
+	Close();
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const string &filename) {
+	Close();
+
+	HANDLE file = CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping) {
+		CloseHandle(file);
+		return false;
+	}
+	data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle		= file;
+	mappingHandle	= mapping;
+	size			= (size_t)fileSize.QuadPart;
+
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data) {
+		UnmapViewOfFile(data);
+		CloseHandle((HANDLE)mappingHandle);
+		CloseHandle((HANDLE)fileHandle);
+	}
+	fileHandle		= NULL;
+	mappingHandle	= NULL;
+	data			= NULL;
+	size			= 0;
+}
+#else
+bool MappedFile::Open(const string &filename) {
+	Close();
+
+	int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0) {
+		return false;
+	}
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0) {
+		close(file);
+		return false;
+	}
+	void* mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);	//The mapping keeps its own reference to the file
+
+	if (mapping == MAP_FAILED) {
+		return false;
+	}
+	data = (const unsigned char*)mapping;
+	size = (size_t)info.st_size;
+
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data) {
+		munmap((void*)data, size);
+	}
+	data = NULL;
+	size = 0;
+}
+#endif
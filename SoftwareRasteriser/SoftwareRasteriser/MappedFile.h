@@ -0,0 +1,38 @@
+/******************************************************************************
+Class:MappedFile
+Implements:
+Description:Read only view of a whole file, mapped straight into our address
+space by the OS. Saves reading everything into a buffer first - the pages
+are only pulled in from disk as we touch them, and there's no extra copy.
+
+-_-_-_-_-_-_-_,------,   
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""   
+
+*//////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <string>
+
+using std::string;
+
+class MappedFile	{
+public:
+	MappedFile(void);
+	~MappedFile(void);
+
+	bool	Open(const string &filename);
+	void	Close();
+
+	const unsigned char*	GetData()	{ return data;}
+	size_t					GetSize()	{ return size;}
+
+protected:
+	//Kept as void* so that everyone including us doesn't get windows.h too
+	void*	fileHandle;
+	void*	mappingHandle;
+
+	const unsigned char*	data;
+	size_t					size;
+};
@@ -1,164 +1,697 @@
-#include "Mesh.h"
-
-
-Mesh::Mesh(void)	{
-	type			= PRIMITIVE_POINTS;
-
-	numVertices		= 0;
-
-	vertices		= NULL;
-	colours			= NULL;
-	textureCoords	= NULL;
-}
-
-Mesh::~Mesh(void)	{
-	delete[] vertices;
-	delete[] colours;
-	delete[] textureCoords;
-}
-
-Mesh* Mesh::GenerateLinestrip(const vector<Vector3> &points)
-{
-	Mesh* m = new Mesh();
-
-	m->numVertices = points.size();
-
-	m->vertices = new Vector4[m->numVertices];
-
-	for (uint i = 0; i < m->numVertices; ++i){
-		m->vertices[i] = Vector4(points[i].x, points[i].y, points[i].z, 1.0f);
-	}
-
-	m->type = PRIMITIVE_LINESTRIP;
-
-	return m;
-}
-
-Mesh* Mesh::GenerateLineloop(const vector<Vector3> &points)
-{
-	Mesh* m = new Mesh();
-
-	m->numVertices = points.size();
-
-	m->vertices = new Vector4[m->numVertices];
-
-	for (uint i = 0; i < m->numVertices; ++i){
-		m->vertices[i] = Vector4(points[i].x, points[i].y, points[i].z, 1.0f);
-	}
-
-	m->type = PRIMITIVE_LINELOOP;
-
-	return m;
-}
-
-Mesh* Mesh::GenerateLine(const Vector3 &from, const Vector3 &to)
-{
-	Mesh* m = new Mesh();
-
-	m->numVertices = 2;
-
-	m->vertices = new Vector4[m->numVertices];
-	m->colours = new Colour[m->numVertices];
-	
-	m->vertices[0] = Vector4(from.x, from.y, from.z, 1.0f);
-	m->vertices[1] = Vector4(to.x, to.y, to.z, 1.0f);
-
-	m->colours[0] = Colour(250, 243, 29, 255);
-	m->colours[1] = Colour(250, 243, 29, 255);
-
-	m->type = PRIMITIVE_LINES;
-
-	return m;
-}
-
-Mesh* Mesh::GeneratePoints(const vector<Vector3> &points) {
-	Mesh* m = new Mesh();
-
-	m->numVertices = points.size();
-
-	m->vertices = new Vector4[m->numVertices];
-
-	for (uint i = 0; i < m->numVertices; ++i){
-		m->vertices[i] = Vector4(points[i].x, points[i].y, points[i].z, 1.0f);
-	}
-	
-	m->type = PRIMITIVE_POINTS;
-
-	return m;
-
-}
-
-Mesh* Mesh::GenerateTriangle(const Vector3 &p1, const Vector3 &p2, const Vector3 &p3){
-	Mesh* m = new Mesh();
-	m->type = PRIMITIVE_TRIANGLES;
-	m->numVertices = 3;
-
-	m->vertices = new Vector4[m->numVertices];
-	m->colours = new Colour[m->numVertices];
-	
-	m->vertices[0] = Vector4(p1.x, p1.y, p1.z, 1.0f);
-	m->vertices[1] = Vector4(p2.x, p2.y, p2.z, 1.0f);
-	m->vertices[2] = Vector4(p3.x, p3.y, p3.z, 1.0f);
-
-	m->colours[0] = Colour(255, 0, 0, 255); // Red
-	m->colours[1] = Colour(0, 255, 0, 255); // Green
-	m->colours[2] = Colour(0, 0, 255, 255); // Blue
-
-	return m;
-}
-
-Mesh* Mesh::GenerateTriFan(const vector<Vector3> &points){
-	Mesh* m = new Mesh();
-	
-	m->numVertices = points.size();
-
-	m->vertices = new Vector4[m->numVertices];
-	m->colours = new Colour[m->numVertices];
-
-	for (uint i = 0; i < m->numVertices; ++i){
-		m->vertices[i] = Vector4(points[i].x, points[i].y, points[i].z, 1.0f);
-		m->colours[i] = Colour(250, 243, 29, 255); //YELLOW
-	}
-	
-	m->type = PRIMITIVE_TRIFAN;
-	
-	return m;
-}
-
-Mesh* Mesh::LoadMeshFile(const string &filename){
-	ifstream f(filename);
-
-	if (!f){
-		return NULL;
-	}
-
-	Mesh*m = new Mesh();
-	m->type = PRIMITIVE_TRIANGLES;
-	f >> m->numVertices;
-
-	int hasTex = 0;
-	int hasColour = 0;
-
-	f >> hasTex;
-	f >> hasColour;
-
-	m->vertices = new Vector4[m->numVertices];
-	m->textureCoords = new Vector2[m->numVertices];
-	m->colours = new Colour[m->numVertices];
-
-	for (uint i = 0; i < m->numVertices; ++i){
-		f >> m->vertices[i].x;
-		f >> m->vertices[i].y;
-		f >> m->vertices[i].z;
-	}
-
-	if (hasColour){
-		for (uint i = 0; i < m->numVertices; ++i){
-			f >> m->colours[i].r; 
-			f >> m->colours[i].g;
-			f >> m->colours[i].b;
-			f >> m->colours[i].a;
-		}
-	}
-	return m;
-}
\ No newline at end of file
+#include "Mesh.h"
+#include <map>
+#include <algorithm>
+#include <cmath>
+
+Mesh::Mesh(void)	{
+	type			= PRIMITIVE_POINTS;
+
+	numVertices		= 0;
+	attributes		= 0;
+
+	positionX		= NULL;
+	positionY		= NULL;
+	positionZ		= NULL;
+	colours			= NULL;
+	texCoordU		= NULL;
+	texCoordV		= NULL;
+	boneIndices		= NULL;
+	numBones		= 0;
+
+	for (int i = 0; i < MAX_VERTEX_BONES; ++i) {
+		boneWeights[i] = NULL;
+	}
+	lodError		= 0.0f;
+}
+
+Mesh::~Mesh(void)	{
+	FreeStream(positionX);
+	FreeStream(positionY);
+	FreeStream(positionZ);
+	FreeStream(colours);
+	FreeStream(texCoordU);
+	FreeStream(texCoordV);
+	FreeStream(boneIndices);
+
+	for (int i = 0; i < MAX_VERTEX_BONES; ++i) {
+		FreeStream(boneWeights[i]);
+	}
+	for (uint i = 0; i < lods.size(); ++i) {
+		delete lods[i];
+	}
+}
+
+void* Mesh::AllocateStream(uint numVertices, size_t elementSize) {
+	size_t padded	= ((size_t)numVertices + VERTEX_BATCH_SIZE - 1) & ~(size_t)(VERTEX_BATCH_SIZE - 1);
+	padded			= max(padded, (size_t)VERTEX_BATCH_SIZE);
+
+	//A silly vertex count could wrap around to something small on 32 bit
+	if (padded > ((size_t)-1) / elementSize) {
+		return NULL;
+	}
+	size_t bytes	= padded * elementSize;
+
+	void* stream = AlignedAlloc(bytes, VERTEX_STREAM_ALIGNMENT);
+	if (stream) {
+		memset(stream, 0, bytes);
+	}
+
+	return stream;
+}
+
+void Mesh::FreeStream(void* stream) {
+	if (stream) {
+		AlignedFree(stream);
+	}
+}
+
+bool Mesh::AllocateStreams(uint numVertices, uint attributes) {
+	this->numVertices	= numVertices;
+	this->attributes	= attributes | VERTEX_POSITION;
+
+	positionX = (float*)AllocateStream(numVertices, sizeof(float));
+	positionY = (float*)AllocateStream(numVertices, sizeof(float));
+	positionZ = (float*)AllocateStream(numVertices, sizeof(float));
+
+	if (attributes & VERTEX_COLOUR) {
+		colours = (Colour*)AllocateStream(numVertices, sizeof(Colour));
+	}
+	if (attributes & VERTEX_TEXCOORD) {
+		texCoordU = (float*)AllocateStream(numVertices, sizeof(float));
+		texCoordV = (float*)AllocateStream(numVertices, sizeof(float));
+	}
+	if (attributes & VERTEX_SKIN) {
+		boneIndices = (unsigned int*)AllocateStream(numVertices, sizeof(unsigned int));
+		for (int i = 0; i < MAX_VERTEX_BONES; ++i) {
+			boneWeights[i] = (float*)AllocateStream(numVertices, sizeof(float));
+		}
+	}
+	//Whatever did get allocated is freed along with the mesh
+	if (!positionX || !positionY || !positionZ ||
+		((attributes & VERTEX_COLOUR) && !colours) ||
+		((attributes & VERTEX_TEXCOORD) && (!texCoordU || !texCoordV))) {
+		return false;
+	}
+	if (attributes & VERTEX_SKIN) {
+		if (!boneIndices) {
+			return false;
+		}
+		for (int i = 0; i < MAX_VERTEX_BONES; ++i) {
+			if (!boneWeights[i]) {
+				return false;
+			}
+		}
+		//Everything starts off entirely on bone 0
+		for (uint i = 0; i < numVertices; ++i) {
+			boneWeights[0][i] = 1.0f;
+		}
+		numBones = 1;
+	}
+	return true;
+}
+
+void Mesh::SetSkin(uint i, const unsigned char bones[MAX_VERTEX_BONES], const float weights[MAX_VERTEX_BONES]) {
+	unsigned int packed = 0;
+	for (int b = 0; b < MAX_VERTEX_BONES; ++b) {
+		packed |= (unsigned int)bones[b] << (b * 8);
+		boneWeights[b][i] = weights[b];
+
+		numBones = max(numBones, (uint)bones[b] + 1);
+	}
+	boneIndices[i] = packed;
+}
+
+size_t Mesh::GetStreamBytes() const {
+	size_t perVertex = 3 * sizeof(float);
+
+	if (colours) {
+		perVertex += sizeof(Colour);
+	}
+	if (texCoordU) {
+		perVertex += 2 * sizeof(float);
+	}
+	if (boneIndices) {
+		perVertex += sizeof(unsigned int) + (MAX_VERTEX_BONES * sizeof(float));
+	}
+	return numVertices * perVertex;
+}
+
+Mesh* Mesh::GenerateEmpty(PrimitiveType type, uint numVertices, uint attributes) {
+	Mesh* m = new Mesh();
+
+	m->type = type;
+	if (!m->AllocateStreams(numVertices, attributes)) {
+		delete m;
+		return NULL;
+	}
+	return m;
+}
+
+Mesh* Mesh::GenerateLinestrip(const vector<Vector3> &points)
+{
+	Mesh* m = GenerateEmpty(PRIMITIVE_LINESTRIP, points.size(), VERTEX_POSITION);
+
+	for (uint i = 0; i < m->numVertices; ++i){
+		m->SetPosition(i, points[i]);
+	}
+
+	m->UpdateBounds();
+	return m;
+}
+
+Mesh* Mesh::GenerateLineloop(const vector<Vector3> &points)
+{
+	Mesh* m = GenerateEmpty(PRIMITIVE_LINELOOP, points.size(), VERTEX_POSITION);
+
+	for (uint i = 0; i < m->numVertices; ++i){
+		m->SetPosition(i, points[i]);
+	}
+
+	m->UpdateBounds();
+	return m;
+}
+
+Mesh* Mesh::GenerateLine(const Vector3 &from, const Vector3 &to)
+{
+	Mesh* m = GenerateEmpty(PRIMITIVE_LINES, 2, VERTEX_POSITION | VERTEX_COLOUR);
+
+	m->SetPosition(0, from);
+	m->SetPosition(1, to);
+
+	m->colours[0] = Colour(250, 243, 29, 255);
+	m->colours[1] = Colour(250, 243, 29, 255);
+
+	m->UpdateBounds();
+	return m;
+}
+
+Mesh* Mesh::GeneratePoints(const vector<Vector3> &points) {
+	Mesh* m = GenerateEmpty(PRIMITIVE_POINTS, points.size(), VERTEX_POSITION);
+
+	for (uint i = 0; i < m->numVertices; ++i){
+		m->SetPosition(i, points[i]);
+	}
+
+	m->UpdateBounds();
+	return m;
+
+}
+
+Mesh* Mesh::GenerateTriangle(const Vector3 &p1, const Vector3 &p2, const Vector3 &p3){
+	Mesh* m = GenerateEmpty(PRIMITIVE_TRIANGLES, 3, VERTEX_POSITION | VERTEX_COLOUR);
+
+	m->SetPosition(0, p1);
+	m->SetPosition(1, p2);
+	m->SetPosition(2, p3);
+
+	m->colours[0] = Colour(255, 0, 0, 255); // Red
+	m->colours[1] = Colour(0, 255, 0, 255); // Green
+	m->colours[2] = Colour(0, 0, 255, 255); // Blue
+
+	m->UpdateBounds();
+	return m;
+}
+
+Mesh* Mesh::GenerateTriFan(const vector<Vector3> &points){
+	Mesh* m = GenerateEmpty(PRIMITIVE_TRIFAN, points.size(), VERTEX_POSITION | VERTEX_COLOUR);
+
+	for (uint i = 0; i < m->numVertices; ++i){
+		m->SetPosition(i, points[i]);
+		m->colours[i] = Colour(250, 243, 29, 255); //YELLOW
+	}
+
+	m->UpdateBounds();
+	return m;
+}
+
+Mesh* Mesh::LoadMeshFile(const string &filename){
+	ifstream f(filename);
+
+	if (!f){
+		return NULL;
+	}
+
+	uint numVertices = 0;
+	int hasTex = 0;
+	int hasColour = 0;
+
+	f >> numVertices;
+	f >> hasTex;
+	f >> hasColour;
+
+	//Only make the streams the file actually has
+	uint attributes = VERTEX_POSITION;
+	if (hasColour) {
+		attributes |= VERTEX_COLOUR;
+	}
+	if (hasTex) {
+		attributes |= VERTEX_TEXCOORD;
+	}
+	Mesh*m = GenerateEmpty(PRIMITIVE_TRIANGLES, numVertices, attributes);
+	if (!m) {
+		return NULL;	//A broken vertex count, most likely
+	}
+
+	for (uint i = 0; i < m->numVertices; ++i){
+		f >> m->positionX[i];
+		f >> m->positionY[i];
+		f >> m->positionZ[i];
+	}
+
+	if (hasColour){
+		for (uint i = 0; i < m->numVertices; ++i){
+			f >> m->colours[i].r; 
+			f >> m->colours[i].g;
+			f >> m->colours[i].b;
+			f >> m->colours[i].a;
+		}
+	}
+
+	if (hasTex){
+		for (uint i = 0; i < m->numVertices; ++i){
+			f >> m->texCoordU[i];
+			f >> m->texCoordV[i];
+		}
+	}
+	m->UpdateBounds();
+	return m;
+}
+
+void Mesh::UpdateBounds() {
+	if (numVertices == 0) {
+		boundsMin = Vector3();
+		boundsMax = Vector3();
+		return;
+	}
+	boundsMin = Vector3(positionX[0], positionY[0], positionZ[0]);
+	boundsMax = boundsMin;
+
+	for (uint i = 1; i < numVertices; ++i) {
+		boundsMin.x = min(boundsMin.x, positionX[i]);
+		boundsMin.y = min(boundsMin.y, positionY[i]);
+		boundsMin.z = min(boundsMin.z, positionZ[i]);
+
+		boundsMax.x = max(boundsMax.x, positionX[i]);
+		boundsMax.y = max(boundsMax.y, positionY[i]);
+		boundsMax.z = max(boundsMax.z, positionZ[i]);
+	}
+}
+
+/*
+Mesh simplification, using Garland and Heckbert's quadric error metric. Each
+vertex keeps a quadric - the sum of the squared distances to the planes of
+every triangle it's been part of - so the cost of moving it anywhere is just
+v^T Q v. When an edge collapses, the quadrics of its two ends are added
+together, so the merged vertex still remembers all of the original surface.
+
+Our meshes are triangle soups, so positions are welded together first, or
+there'd be no shared edges to collapse. The colours and texcoords stay with
+the triangle corners they started on.
+*/
+struct Quadric {
+	double q[10];	//The upper half of a symmetric 4x4 matrix
+
+	Quadric() {
+		memset(q, 0, sizeof(q));
+	}
+
+	void AddPlane(double a, double b, double c, double d, double weight) {
+		q[0] += weight * a * a;	q[1] += weight * a * b; q[2] += weight * a * c; q[3] += weight * a * d;
+		q[4] += weight * b * b;	q[5] += weight * b * c; q[6] += weight * b * d;
+		q[7] += weight * c * c;	q[8] += weight * c * d;
+		q[9] += weight * d * d;
+	}
+
+	void operator+=(const Quadric &o) {
+		for (int i = 0; i < 10; ++i) {
+			q[i] += o.q[i];
+		}
+	}
+
+	double Error(const Vector3 &v) const {
+		double x = v.x;
+		double y = v.y;
+		double z = v.z;
+
+		return	(q[0] * x * x) + (2.0 * q[1] * x * y) + (2.0 * q[2] * x * z) + (2.0 * q[3] * x) +
+				(q[4] * y * y) + (2.0 * q[5] * y * z) + (2.0 * q[6] * y) +
+				(q[7] * z * z) + (2.0 * q[8] * z) +
+				 q[9];
+	}
+
+	//The planes' normals are all unit length, so the diagonal adds up to the
+	//total weight of them - which turns Error into an average squared distance
+	double Weight() const {
+		return q[0] + q[4] + q[7];
+	}
+};
+
+struct PositionLess {
+	bool operator()(const Vector3 &a, const Vector3 &b) const {
+		if (a.x != b.x) {
+			return a.x < b.x;
+		}
+		if (a.y != b.y) {
+			return a.y < b.y;
+		}
+		return a.z < b.z;
+	}
+};
+
+struct EdgeCollapse {
+	double	cost;
+	uint	from;	//Gets merged into 'to'
+	uint	to;
+	Vector3 position;
+
+	bool operator<(const EdgeCollapse &o) const {
+		return cost < o.cost;
+	}
+};
+
+class MeshSimplifier {
+public:
+	MeshSimplifier(const Mesh* m) {
+		std::map<Vector3, uint, PositionLess> welded;
+
+		uint numTris = m->GetNumVertices() / 3;
+
+		for (uint i = 0; i < numTris * 3; ++i) {
+			Vector4 v = m->GetPosition(i);
+			Vector3 p(v.x, v.y, v.z);
+
+			std::map<Vector3, uint, PositionLess>::iterator w = welded.find(p);
+			if (w == welded.end()) {
+				w = welded.insert(std::make_pair(p, (uint)positions.size())).first;
+				positions.push_back(p);
+			}
+			corners.push_back(w->second);
+			sources.push_back(i);
+		}
+		quadrics.resize(positions.size());
+		vertexTris.resize(positions.size());
+		alive.resize(numTris, true);
+
+		liveTris = 0;
+		maxError = 0.0f;
+
+		//Edges only used by one triangle are on the edge of a hole, and
+		//would get eaten away - so they get a plane at right angles to the
+		//triangle, which is expensive to move away from
+		std::map<std::pair<uint, uint>, int> edgeUses;
+
+		for (uint t = 0; t < numTris; ++t) {
+			uint* c = &corners[t * 3];
+
+			if (c[0] == c[1] || c[1] == c[2] || c[2] == c[0]) {
+				alive[t] = false;
+				continue;
+			}
+			Vector3 normal	= Vector3::Cross(positions[c[1]] - positions[c[0]], positions[c[2]] - positions[c[0]]);
+			float	area	= normal.Length() * 0.5f;
+
+			if (area > 0.0f) {
+				normal = normal / (area * 2.0f);
+				double d = -Vector3::Dot(normal, positions[c[0]]);
+
+				for (int k = 0; k < 3; ++k) {
+					quadrics[c[k]].AddPlane(normal.x, normal.y, normal.z, d, area);
+				}
+				for (int k = 0; k < 3; ++k) {
+					edgeUses[std::make_pair(min(c[k], c[(k + 1) % 3]), max(c[k], c[(k + 1) % 3]))]++;
+				}
+			}
+			for (int k = 0; k < 3; ++k) {
+				vertexTris[c[k]].push_back(t);
+			}
+			liveTris++;
+		}
+		for (uint t = 0; t < numTris; ++t) {
+			if (!alive[t]) {
+				continue;
+			}
+			uint* c = &corners[t * 3];
+
+			Vector3 normal	= Vector3::Cross(positions[c[1]] - positions[c[0]], positions[c[2]] - positions[c[0]]);
+			float	area	= normal.Length() * 0.5f;
+
+			if (area <= 0.0f) {
+				continue;
+			}
+			normal = normal / (area * 2.0f);
+
+			for (int k = 0; k < 3; ++k) {
+				uint a = c[k];
+				uint b = c[(k + 1) % 3];
+
+				if (edgeUses[std::make_pair(min(a, b), max(a, b))] != 1) {
+					continue;
+				}
+				Vector3 edge = positions[b] - positions[a];
+
+				Vector3 side = Vector3::Cross(edge, normal);
+				float length = side.Length();
+				if (length <= 0.0f) {
+					continue;
+				}
+				side = side / length;
+				double d = -Vector3::Dot(side, positions[a]);
+
+				quadrics[a].AddPlane(side.x, side.y, side.z, d, edge.LengthSquared() * 100.0f);
+				quadrics[b].AddPlane(side.x, side.y, side.z, d, edge.LengthSquared() * 100.0f);
+			}
+		}
+	}
+
+	//Collapses edges, cheapest first, until there's no more than 'target'
+	//triangles left, or nothing else can go without folding the mesh over
+	void Reduce(uint target) {
+		while (liveTris > target) {
+			vector<EdgeCollapse> edges;
+			GatherEdges(edges);
+
+			std::sort(edges.begin(), edges.end());
+
+			//Once a vertex has moved, the costs around it are out of date,
+			//so each pass only touches any vertex once
+			vector<bool> touched(positions.size(), false);
+			uint collapsed = 0;
+
+			for (uint i = 0; i < edges.size() && liveTris > target; ++i) {
+				const EdgeCollapse &e = edges[i];
+
+				if (touched[e.from] || touched[e.to] || FoldsOver(e)) {
+					continue;
+				}
+				for (uint j = 0; j < vertexTris[e.to].size(); ++j) {
+					uint t = vertexTris[e.to][j];
+					for (int k = 0; k < 3; ++k) {
+						touched[corners[t * 3 + k]] = true;
+					}
+				}
+				for (uint j = 0; j < vertexTris[e.from].size(); ++j) {
+					uint t = vertexTris[e.from][j];
+					for (int k = 0; k < 3; ++k) {
+						touched[corners[t * 3 + k]] = true;
+					}
+				}
+				Collapse(e);
+				collapsed++;
+			}
+			if (collapsed == 0) {
+				return;
+			}
+		}
+	}
+
+	Mesh* Output(const Mesh* source) const {
+		Mesh* m = Mesh::GenerateEmpty(PRIMITIVE_TRIANGLES, liveTris * 3, source->GetAttributes());
+		if (!m) {
+			return NULL;
+		}
+
+		uint v = 0;
+		for (uint t = 0; t < alive.size(); ++t) {
+			if (!alive[t]) {
+				continue;
+			}
+			for (int k = 0; k < 3; ++k, ++v) {
+				uint src = sources[t * 3 + k];
+
+				m->SetPosition(v, positions[corners[t * 3 + k]]);
+
+				if (source->GetAttributes() & VERTEX_COLOUR) {
+					m->SetColour(v, source->GetColour(src));
+				}
+				if (source->GetAttributes() & VERTEX_TEXCOORD) {
+					Vector3 tex = source->GetTexCoord(src);
+					m->SetTexCoord(v, Vector2(tex.x, tex.y));
+				}
+			}
+		}
+		m->UpdateBounds();
+		return m;
+	}
+
+	uint	liveTris;
+	float	maxError;	//The furthest any vertex is from the surface it came from, on average
+
+protected:
+	void GatherEdges(vector<EdgeCollapse> &edges) {
+		vector<std::pair<uint, uint> > pairs;
+
+		for (uint t = 0; t < alive.size(); ++t) {
+			if (!alive[t]) {
+				continue;
+			}
+			for (int k = 0; k < 3; ++k) {
+				uint a = corners[t * 3 + k];
+				uint b = corners[t * 3 + ((k + 1) % 3)];
+				pairs.push_back(std::make_pair(min(a, b), max(a, b)));
+			}
+		}
+		std::sort(pairs.begin(), pairs.end());
+		pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+		for (uint i = 0; i < pairs.size(); ++i) {
+			uint a = pairs[i].first;
+			uint b = pairs[i].second;
+
+			Quadric q = quadrics[a];
+			q += quadrics[b];
+
+			//Rather than solving for the very best spot, try either end and
+			//the middle - it's much simpler, and nearly as good
+			Vector3 candidates[3] = { positions[a], positions[b], (positions[a] + positions[b]) * 0.5f };
+
+			EdgeCollapse e;
+			e.from	= b;
+			e.to	= a;
+			e.cost	= q.Error(candidates[0]);
+			e.position = candidates[0];
+
+			for (int c = 1; c < 3; ++c) {
+				double cost = q.Error(candidates[c]);
+				if (cost < e.cost) {
+					e.cost		= cost;
+					e.position	= candidates[c];
+				}
+			}
+			edges.push_back(e);
+		}
+	}
+
+	//Would moving the edge's vertices to the new position flip any of the
+	//triangles around them? Those that are on the edge itself disappear,
+	//so they don't count
+	bool FoldsOver(const EdgeCollapse &e) const {
+		uint ends[2] = { e.from, e.to };
+
+		for (int i = 0; i < 2; ++i) {
+			const vector<uint> &tris = vertexTris[ends[i]];
+
+			for (uint j = 0; j < tris.size(); ++j) {
+				uint t = tris[j];
+				if (!alive[t]) {
+					continue;
+				}
+				const uint* c = &corners[t * 3];
+
+				bool hasFrom	= (c[0] == e.from || c[1] == e.from || c[2] == e.from);
+				bool hasTo		= (c[0] == e.to	  || c[1] == e.to	|| c[2] == e.to);
+				if (hasFrom && hasTo) {
+					continue;
+				}
+				Vector3 before[3];
+				Vector3 after[3];
+				for (int k = 0; k < 3; ++k) {
+					before[k]	= positions[c[k]];
+					after[k]	= (c[k] == e.from || c[k] == e.to) ? e.position : before[k];
+				}
+				Vector3 oldNormal = Vector3::Cross(before[1] - before[0], before[2] - before[0]);
+				Vector3 newNormal = Vector3::Cross(after[1]  - after[0],  after[2]  - after[0]);
+
+				if (Vector3::Dot(oldNormal, newNormal) < 0.0f) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void Collapse(const EdgeCollapse &e) {
+		positions[e.to] = e.position;
+		quadrics[e.to] += quadrics[e.from];
+
+		double weight = quadrics[e.to].Weight();
+		if (weight > 0.0) {
+			maxError = max(maxError, (float)sqrt(max(e.cost, 0.0) / weight));
+		}
+
+		vector<uint> &tris = vertexTris[e.from];
+
+		for (uint j = 0; j < tris.size(); ++j) {
+			uint t = tris[j];
+			if (!alive[t]) {
+				continue;
+			}
+			uint* c = &corners[t * 3];
+
+			if (c[0] == e.to || c[1] == e.to || c[2] == e.to) {
+				alive[t] = false;	//It's the edge itself - now it has no area
+				liveTris--;
+				continue;
+			}
+			for (int k = 0; k < 3; ++k) {
+				if (c[k] == e.from) {
+					c[k] = e.to;
+				}
+			}
+			vertexTris[e.to].push_back(t);
+		}
+		tris.clear();
+	}
+
+	vector<Vector3>			positions;	//One per distinct position
+	vector<Quadric>			quadrics;
+	vector<uint>			corners;	//3 per triangle, indices into positions
+	vector<uint>			sources;	//The original vertex each corner came from
+	vector<bool>			alive;
+	vector<vector<uint> >	vertexTris;
+};
+
+void Mesh::GenerateLODs(uint maxLevels, float reduction) {
+	for (uint i = 0; i < lods.size(); ++i) {
+		delete lods[i];
+	}
+	lods.clear();
+
+	UpdateBounds();
+
+	if (type != PRIMITIVE_TRIANGLES || numVertices < 3 || HasSkin()) {
+		return;
+	}
+	MeshSimplifier simplifier(this);
+
+	uint triangles = simplifier.liveTris;
+
+	for (uint level = 1; level < maxLevels; ++level) {
+		uint target = (uint)(triangles * reduction);
+		if (target < 4) {
+			break;	//There's not much left to take away!
+		}
+		simplifier.Reduce(target);
+
+		if (simplifier.liveTris >= triangles) {
+			break;	//Couldn't get any simpler
+		}
+		Mesh* lod		= simplifier.Output(this);
+		if (!lod) {
+			break;
+		}
+		lod->lodError	= simplifier.maxError;
+		lods.push_back(lod);
+
+		triangles = simplifier.liveTris;
+	}
+}
@@ -1,65 +1,170 @@
-/******************************************************************************
-Class:Mesh
-Implements:
-Author:Rich Davison	<richard.davison4@newcastle.ac.uk>
-Description: Class to represent the geometric data that makes up the meshes
-we render on screen.
-
--_-_-_-_-_-_-_,------,   
-_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
--_-_-_-_-_-_-~|__( ^ .^) /
-_-_-_-_-_-_-_-""  ""   
-
-*//////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "Vector4.h"
-#include "Colour.h"
-#include "Vector3.h"
-#include "Vector2.h"
-#include "Common.h"
-#include <vector>
-#include <string>
-#include <fstream>
-
-using std::ifstream;
-using std::vector;
-using std::string;
-
-enum PrimitiveType {
-	PRIMITIVE_POINTS,
-	PRIMITIVE_LINES,
-	PRIMITIVE_LINESTRIP,
-	PRIMITIVE_LINELOOP,
-	PRIMITIVE_TRIANGLES,
-	PRIMITIVE_TRIFAN
-};
-
-class Mesh	{
-	friend class SoftwareRasteriser;
-public:
-	Mesh(void);
-	~Mesh(void);
-
-	static Mesh*	GenerateTriangle(const Vector3 &p1, const Vector3 &p2, const Vector3 &p3);
-	static Mesh*	GenerateLine(const Vector3 &from, const Vector3 &to);
-	static Mesh*	GeneratePoints(const vector<Vector3> &points);
-
-	static Mesh* GenerateTriFan(const vector<Vector3> &points);
-
-	static Mesh*	GenerateLinestrip(const vector<Vector3> &points);
-	static Mesh*	GenerateLineloop(const vector<Vector3> &points);
-	static Mesh*	LoadMeshFile(const string & filename);
-	PrimitiveType	GetType() { return type;}
-
-protected:
-	PrimitiveType	type;
-
-	uint			numVertices;
-
-	Vector4*		vertices;
-	Colour*			colours;
-	Vector2*		textureCoords;	//We get onto what to do with these later on...
-};
-
+/******************************************************************************
+Class:Mesh
+Implements:
+Author:Rich Davison	<richard.davison4@newcastle.ac.uk>
+Description: Class to represent the geometric data that makes up the meshes
+we render on screen.
+
+-_-_-_-_-_-_-_,------,   
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""   
+
+*//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Vector4.h"
+#include "Colour.h"
+#include "Vector3.h"
+#include "Vector2.h"
+#include "Common.h"
+#include <vector>
+#include <string>
+#include <fstream>
+
+using std::ifstream;
+using std::vector;
+using std::string;
+
+//The vertex streams a Mesh can have. There are always positions, but the
+//rest are only allocated if a mesh actually uses them
+enum VertexAttribute {
+	VERTEX_POSITION = 1,
+	VERTEX_COLOUR	= 2,
+	VERTEX_TEXCOORD = 4,
+	VERTEX_SKIN		= 8		//Bone indices and weights
+};
+
+//How many bones can move each vertex of a skinned mesh
+#define MAX_VERTEX_BONES 4
+
+//Every stream starts on a 32 byte boundary, and is padded (with zeros) out to
+//a whole number of 8 vertex batches, so SIMD loops never need a scalar tail
+#define VERTEX_STREAM_ALIGNMENT	32
+#define VERTEX_BATCH_SIZE		8
+
+enum PrimitiveType {
+	PRIMITIVE_POINTS,
+	PRIMITIVE_LINES,
+	PRIMITIVE_LINESTRIP,
+	PRIMITIVE_LINELOOP,
+	PRIMITIVE_TRIANGLES,
+	PRIMITIVE_TRIFAN
+};
+
+class Mesh	{
+	friend class SoftwareRasteriser;
+	friend class OcclusionBuffer;
+public:
+	Mesh(void);
+	~Mesh(void);
+
+	static Mesh*	GenerateTriangle(const Vector3 &p1, const Vector3 &p2, const Vector3 &p3);
+	static Mesh*	GenerateLine(const Vector3 &from, const Vector3 &to);
+	static Mesh*	GeneratePoints(const vector<Vector3> &points);
+
+	static Mesh* GenerateTriFan(const vector<Vector3> &points);
+
+	static Mesh*	GenerateLinestrip(const vector<Vector3> &points);
+	static Mesh*	GenerateLineloop(const vector<Vector3> &points);
+	static Mesh*	LoadMeshFile(const string & filename);
+
+	//A mesh with room for numVertices, and just the streams asked for. NULL
+	//if there isn't enough memory for them
+	static Mesh*	GenerateEmpty(PrimitiveType type, uint numVertices, uint attributes);
+
+	PrimitiveType	GetType() { return type;}
+
+	uint	GetNumVertices() const	{ return numVertices;}
+	uint	GetAttributes()	 const	{ return attributes;}
+	size_t	GetStreamBytes() const;
+
+	inline Vector4 GetPosition(uint i) const {
+		return Vector4(positionX[i], positionY[i], positionZ[i], 1.0f);
+	}
+	inline void SetPosition(uint i, const Vector3 &p) {
+		positionX[i] = p.x;
+		positionY[i] = p.y;
+		positionZ[i] = p.z;
+	}
+
+	//Meshes without colours are drawn white
+	inline const Colour& GetColour(uint i) const {
+		return colours ? colours[i] : Colour::White;
+	}
+	inline void SetColour(uint i, const Colour &c) {
+		colours[i] = c;
+	}
+
+	inline Vector3 GetTexCoord(uint i) const {
+		return Vector3(texCoordU[i], texCoordV[i], 0.0f);
+	}
+	inline void SetTexCoord(uint i, const Vector2 &t) {
+		texCoordU[i] = t.x;
+		texCoordV[i] = t.y;
+	}
+
+	//Which bones move a vertex, and by how much - the weights should add up
+	//to 1. Bones are indices into a RenderObject's bone palette
+	void	SetSkin(uint i, const unsigned char bones[MAX_VERTEX_BONES], const float weights[MAX_VERTEX_BONES]);
+
+	bool	HasSkin() const		{ return boneIndices != NULL;}
+	//One more than the biggest bone index used
+	uint	GetNumBones() const { return numBones;}
+
+	//NULL if it couldn't be allocated
+	static void*	AllocateStream(uint numVertices, size_t elementSize);
+	static void		FreeStream(void* stream);
+
+	//Works out the model space box around every vertex. Call it again if
+	//you move them about!
+	void			UpdateBounds();
+	const Vector3&	GetBoundsMin() const { return boundsMin;}
+	const Vector3&	GetBoundsMax() const { return boundsMax;}
+
+	//Builds a chain of simplified copies of a triangle mesh, by collapsing
+	//edges until each level has about 'reduction' times as many triangles as
+	//the level before. This is far too slow to do every frame - do it once
+	//when the mesh is loaded, and keep it! Level 0 is always the mesh itself.
+	//Skinned meshes don't get any - the simplifier doesn't know about bones.
+	void			GenerateLODs(uint maxLevels = 4, float reduction = 0.5f);
+
+	uint			GetNumLODs() const { return lods.size() + 1;}
+	Mesh*			GetLOD(uint level) { return level == 0 ? this : lods[level - 1];}
+
+	//Roughly how far (in model space) a level's surface strays from the
+	//full detail mesh
+	float			GetLODError(uint level) const { return level == 0 ? 0.0f : lods[level - 1]->lodError;}
+
+protected:
+	//False if any of them couldn't be allocated
+	bool			AllocateStreams(uint numVertices, uint attributes);
+
+	PrimitiveType	type;
+
+	uint			numVertices;
+	uint			attributes;
+
+	//Structure of arrays - each component gets a stream of its own, so a loop
+	//only pulls in the data it uses, and can load a whole batch of vertices'
+	//worth of it in one go. There's no w, as every vertex has w = 1
+	float*			positionX;
+	float*			positionY;
+	float*			positionZ;
+	Colour*			colours;
+	float*			texCoordU;
+	float*			texCoordV;
+
+	//A byte per bone in each index, and a stream per bone for the weights
+	unsigned int*	boneIndices;
+	float*			boneWeights[MAX_VERTEX_BONES];
+	uint			numBones;
+
+	Vector3			boundsMin;
+	Vector3			boundsMax;
+
+	vector<Mesh*>	lods;		//Only the full detail mesh has any
+	float			lodError;
+};
+
@@ -0,0 +1,249 @@
+#include "OcclusionBuffer.h"
+#include "SIMDKernels.h"
+#include <cmath>
+#include <cfloat>
+#include <map>
+
+using std::map;
+
+//Meshes are triangle soups, so edges are matched up by where their ends are
+struct OccluderEdge {
+	Vector3 from;
+	Vector3 to;
+
+	OccluderEdge(const Vector3 &a, const Vector3 &b) {
+		bool swap = (b.x < a.x) || (b.x == a.x && (b.y < a.y || (b.y == a.y && b.z < a.z)));
+		from	= swap ? b : a;
+		to		= swap ? a : b;
+	}
+
+	bool operator<(const OccluderEdge &o) const {
+		const float* l = &from.x;
+		const float* r = &o.from.x;
+		for (int i = 0; i < 3; ++i) {
+			if (l[i] != r[i]) {
+				return l[i] < r[i];
+			}
+		}
+		l = &to.x;
+		r = &o.to.x;
+		for (int i = 0; i < 3; ++i) {
+			if (l[i] != r[i]) {
+				return l[i] < r[i];
+			}
+		}
+		return false;
+	}
+};
+
+//The edge of a triangle opposite its ith vertex
+static OccluderEdge EdgeOpposite(const Mesh* m, const uint* tri, int i) {
+	Vector4 a = m->GetPosition(tri[(i + 1) % 3]);
+	Vector4 b = m->GetPosition(tri[(i + 2) % 3]);
+
+	return OccluderEdge(Vector3(a.x, a.y, a.z), Vector3(b.x, b.y, b.z));
+}
+
+OcclusionBuffer::OcclusionBuffer(void)	{
+	depth		= (float*)AlignedAlloc(OCCLUSION_WIDTH * OCCLUSION_HEIGHT * sizeof(float), VERTEX_STREAM_ALIGNMENT);
+	x			= NULL;
+	y			= NULL;
+	z			= NULL;
+	invW		= NULL;
+	capacity	= 0;
+
+	//Pixel i covers i to i + 1, so the edges of the screen land on the edges
+	//of the buffer, rather than in the middle of its outside pixels
+	Vector3 half = Vector3(OCCLUSION_WIDTH * 0.5f, OCCLUSION_HEIGHT * 0.5f, 0.5f);
+	portMatrix = Matrix4::Translation(half) * Matrix4::Scale(half);
+
+	Clear();
+}
+
+OcclusionBuffer::~OcclusionBuffer(void)	{
+	AlignedFree(depth);
+	Mesh::FreeStream(x);
+	Mesh::FreeStream(y);
+	Mesh::FreeStream(z);
+	Mesh::FreeStream(invW);
+}
+
+void OcclusionBuffer::Clear() {
+	for (uint i = 0; i < OCCLUSION_WIDTH * OCCLUSION_HEIGHT; ++i) {
+		depth[i] = 1.0f;
+	}
+	empty = true;
+}
+
+void OcclusionBuffer::DrawOccluder(const Mesh* m, const Matrix4 &mvp) {
+	if (m->type != PRIMITIVE_TRIANGLES && m->type != PRIMITIVE_TRIFAN) {
+		return;
+	}
+	if (capacity < m->numVertices) {
+		Mesh::FreeStream(x);
+		Mesh::FreeStream(y);
+		Mesh::FreeStream(z);
+		Mesh::FreeStream(invW);
+
+		x			= (float*)Mesh::AllocateStream(m->numVertices, sizeof(float));
+		y			= (float*)Mesh::AllocateStream(m->numVertices, sizeof(float));
+		z			= (float*)Mesh::AllocateStream(m->numVertices, sizeof(float));
+		invW		= (float*)Mesh::AllocateStream(m->numVertices, sizeof(float));
+		capacity	= m->numVertices;
+	}
+	(portMatrix * mvp).TransformBatch(m->positionX, m->positionY, m->positionZ, m->numVertices,
+		x, y, z, invW);
+
+	vector<uint> tris;
+	if (m->type == PRIMITIVE_TRIANGLES) {
+		for (uint i = 0; i + 2 < m->numVertices; i += 3) {
+			tris.push_back(i);
+			tris.push_back(i + 1);
+			tris.push_back(i + 2);
+		}
+	}
+	else {
+		for (uint i = 1; i + 1 < m->numVertices; ++i) {
+			tris.push_back(0);
+			tris.push_back(i);
+			tris.push_back(i + 1);
+		}
+	}
+	//Edges used by more than one triangle are inside the occluder - the
+	//triangle on the other side covers the rest of the pixels along them
+	map<OccluderEdge, int> uses;
+	for (uint t = 0; t < tris.size(); t += 3) {
+		for (int i = 0; i < 3; ++i) {
+			uses[EdgeOpposite(m, &tris[t], i)]++;
+		}
+	}
+	for (uint t = 0; t < tris.size(); t += 3) {
+		bool outline[3];
+		for (int i = 0; i < 3; ++i) {
+			outline[i] = uses[EdgeOpposite(m, &tris[t], i)] == 1;
+		}
+		DrawTriangle(tris[t], tris[t + 1], tris[t + 2], outline);
+	}
+}
+
+
+/*
+The edges on the occluder's outline are pulled in by half a pixel's worth in
+each direction, so testing them at the middle of a pixel tells us if its
+nearest corner to the edge is inside, and so the whole pixel is. Edges shared
+with another triangle are left where they are - a pixel across one of those
+is covered by one triangle or the other, and shrinking both would leave a
+crack between them. The depth plane is pushed back to the farthest it gets
+across the pixel.
+*/
+void OcclusionBuffer::DrawTriangle(uint a, uint b, uint c, const bool outline[3]) {
+	uint	v[3]	= { a, b, c };
+	float	vx[3], vy[3], vz[3];
+
+	for (int i = 0; i < 3; ++i) {
+		//Behind the camera, or in front of the near plane - there's nothing
+		//drawn there to hide anything with, so the whole triangle's skipped
+		if (invW[v[i]] <= 0.0f || z[v[i]] < 0.0f) {
+			return;
+		}
+		vx[i] = x[v[i]];
+		vy[i] = y[v[i]];
+		vz[i] = z[v[i]];
+	}
+	float area = (vx[1] - vx[0]) * (vy[2] - vy[0]) - (vx[2] - vx[0]) * (vy[1] - vy[0]);
+	if (fabs(area) < 1.0f) {
+		return;	//Couldn't cover a whole pixel anyway
+	}
+	float winding = (area > 0.0f) ? 1.0f : -1.0f;
+
+	float ea[3], eb[3], ec[3];
+	for (int i = 0; i < 3; ++i) {
+		int from	= (i + 1) % 3;
+		int to		= (i + 2) % 3;
+
+		ea[i] = (vy[from] - vy[to]) * winding;
+		eb[i] = (vx[to] - vx[from]) * winding;
+		ec[i] = (vx[from] * vy[to] - vy[from] * vx[to]) * winding;
+		if (outline[i]) {
+			ec[i] -= (fabs(ea[i]) + fabs(eb[i])) * 0.5f;
+		}
+	}
+	float zDx = ((vz[1] - vz[0]) * (vy[2] - vy[0]) - (vz[2] - vz[0]) * (vy[1] - vy[0])) / area;
+	float zDy = ((vz[2] - vz[0]) * (vx[1] - vx[0]) - (vz[1] - vz[0]) * (vx[2] - vx[0])) / area;
+	float zC  = vz[0] - zDx * vx[0] - zDy * vy[0] + (fabs(zDx) + fabs(zDy)) * 0.5f;
+
+	//Only pixels with their middle inside the box can possibly be covered
+	int left	= max(0,					(int)ceil (min(vx[0], min(vx[1], vx[2])) - 0.5f));
+	int right	= min(OCCLUSION_WIDTH - 1,	(int)floor(max(vx[0], max(vx[1], vx[2])) - 0.5f));
+	int top		= max(0,					(int)ceil (min(vy[0], min(vy[1], vy[2])) - 0.5f));
+	int bottom	= min(OCCLUSION_HEIGHT - 1, (int)floor(max(vy[0], max(vy[1], vy[2])) - 0.5f));
+
+	if (left > right || top > bottom) {
+		return;
+	}
+	const SIMDKernelTable &simd = SIMDKernels::Get();
+
+	float px = left + 0.5f;
+	for (int row = top; row <= bottom; ++row) {
+		float py = row + 0.5f;
+
+		float edges[3];
+		for (int i = 0; i < 3; ++i) {
+			edges[i] = ea[i] * px + eb[i] * py + ec[i];
+		}
+		simd.occluderRow(&depth[row * OCCLUSION_WIDTH + left], right - left + 1,
+			edges, ea, zDx * px + zDy * py + zC, zDx);
+	}
+	empty = false;
+}
+
+bool OcclusionBuffer::BoxHidden(const Matrix4 &mvp, const Vector3 &boxMin, const Vector3 &boxMax) const {
+	if (empty) {
+		return false;
+	}
+	Matrix4 m = portMatrix * mvp;
+
+	float minX = FLT_MAX, maxX = -FLT_MAX;
+	float minY = FLT_MAX, maxY = -FLT_MAX;
+	float nearest = FLT_MAX;
+
+	for (int i = 0; i < 8; ++i) {
+		Vector4 corner(	(i & 1) ? boxMax.x : boxMin.x,
+						(i & 2) ? boxMax.y : boxMin.y,
+						(i & 4) ? boxMax.z : boxMin.z, 1.0f);
+
+		Vector4 clip = m * corner;
+
+		//The box goes right up to the camera, so it's in front of everything
+		if (clip.w <= 0.0f) {
+			return false;
+		}
+		float invW = 1.0f / clip.w;
+
+		minX	= min(minX, clip.x * invW);
+		maxX	= max(maxX, clip.x * invW);
+		minY	= min(minY, clip.y * invW);
+		maxY	= max(maxY, clip.y * invW);
+		nearest = min(nearest, clip.z * invW);
+	}
+	if (nearest < 0.0f) {
+		return false;
+	}
+	int left	= max(0,					(int)floor(minX));
+	int right	= min(OCCLUSION_WIDTH - 1,	(int)floor(maxX));
+	int top		= max(0,					(int)floor(minY));
+	int bottom	= min(OCCLUSION_HEIGHT - 1, (int)floor(maxY));
+
+	//Off the screen - not our job to cull it
+	if (left > right || top > bottom) {
+		return false;
+	}
+	const SIMDKernelTable &simd = SIMDKernels::Get();
+
+	for (int row = top; row <= bottom; ++row) {
+		if (simd.occluderTest(&depth[row * OCCLUSION_WIDTH + left], right - left + 1, nearest)) {
+			return false;
+		}
+	}
+	return true;
+}
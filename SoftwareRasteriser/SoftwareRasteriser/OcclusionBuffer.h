@@ -0,0 +1,71 @@
+/******************************************************************************
+Class:OcclusionBuffer
+Implements:
+Description:A tiny depth buffer that a handful of big, simple occluder meshes
+are drawn into before anything else, so that objects hidden behind them can
+be thrown away from just their bounding box - before we've transformed a
+single vertex of them.
+
+It has to be conservative - it's fine to draw something that turns out to be
+hidden, but never to skip something that isn't. So an occluder only counts as
+covering a pixel if it covers all of it (not just the middle), and each pixel
+keeps the farthest depth the occluder has anywhere across it. Boxes then have
+to be behind that everywhere they touch to be hidden.
+
+Depths go from 0 at the near plane to 1 at the far plane.
+
+-_-_-_-_-_-_-_,------,
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""
+
+*//////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Matrix4.h"
+#include "Vector3.h"
+#include "Mesh.h"
+
+//Plenty to hide things with, and small enough to fill in no time at all
+#define OCCLUSION_WIDTH		256
+#define OCCLUSION_HEIGHT	128
+
+class OcclusionBuffer	{
+public:
+	OcclusionBuffer(void);
+	~OcclusionBuffer(void);
+
+	void	Clear();
+
+	//Draws a triangle (or triangle fan) mesh, through mvp. Anything else can't
+	//hide anything, so is ignored
+	void	DrawOccluder(const Mesh* m, const Matrix4 &mvp);
+
+	//True if the whole box is behind what's been drawn so far
+	bool	BoxHidden(const Matrix4 &mvp, const Vector3 &boxMin, const Vector3 &boxMax) const;
+
+	//Nothing drawn since the last Clear, so nothing can be hidden
+	bool	IsEmpty() const { return empty;}
+
+protected:
+	//Takes vertices from the transformed streams. Edge i is the one opposite
+	//vertex i, and is only pulled in to cover whole pixels if it's on the outline
+	void	DrawTriangle(uint a, uint b, uint c, const bool outline[3]);
+
+	float*		depth;
+
+	//DrawOccluder's transformed vertices - these only ever grow
+	float*		x;
+	float*		y;
+	float*		z;
+	float*		invW;
+	uint		capacity;
+
+	Matrix4		portMatrix;		//Like SoftwareRasteriser's, but to our size, and depth 0 to 1
+	bool		empty;
+
+private:
+	//Owns its buffers, so can't be copied
+	OcclusionBuffer(const OcclusionBuffer &o);
+	OcclusionBuffer& operator=(const OcclusionBuffer &o);
+};
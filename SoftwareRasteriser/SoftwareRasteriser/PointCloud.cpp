@@ -0,0 +1,431 @@
+#include "PointCloud.h"
+
+#include <fstream>
+#include <algorithm>
+
+/*
+Octree files start with this header, then a record for every node (the root
+is always first), and then the points of each node, one after the other.
+*/
+struct PointCloudHeader {
+	char				id[4];
+	unsigned int		numNodes;
+	unsigned long long	totalPoints;
+};
+
+struct PointCloudNodeRecord {
+	float				boundsMin[3];
+	float				boundsMax[3];
+	int					children[8];
+	unsigned int		numPoints;
+	unsigned long long	fileOffset;
+};
+
+struct PointCloudPoint {
+	float			x;
+	float			y;
+	float			z;
+	unsigned int	colour;
+};
+
+//Stops a pile of points in exactly the same place from splitting forever
+#define MAX_OCTREE_DEPTH 20
+
+struct BuildNode {
+	Vector3			boundsMin;
+	Vector3			boundsMax;
+	int				children[8];
+	vector<uint>	points;
+};
+
+/*
+Each node is split up into a nodeGrid^3 grid, and keeps the first point that
+lands in each cell. That gives an evenly spread sample of everything inside
+the node, no matter how dense the points are. Anything that didn't get a cell
+is sorted into the node's octants, to be sampled by the children.
+*/
+static void BuildOctree(vector<BuildNode> &nodes, int index, vector<uint> &candidates,
+	const vector<Vector3> &points, uint nodeGrid, int depth) {
+	Vector3 bMin = nodes[index].boundsMin;
+	Vector3 bMax = nodes[index].boundsMax;
+	Vector3 size = bMax - bMin;
+
+	uint cells = nodeGrid * nodeGrid * nodeGrid;
+
+	if (candidates.size() <= cells || depth == MAX_OCTREE_DEPTH) {
+		nodes[index].points.swap(candidates);
+		return;
+	}
+	vector<bool>	taken(cells, false);
+	vector<uint>	octants[8];
+	vector<uint>	kept;
+
+	Vector3 centre = bMin + (size * 0.5f);
+
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		const Vector3 &p = points[candidates[i]];
+
+		uint cx = min((uint)(((p.x - bMin.x) / size.x) * nodeGrid), nodeGrid - 1);
+		uint cy = min((uint)(((p.y - bMin.y) / size.y) * nodeGrid), nodeGrid - 1);
+		uint cz = min((uint)(((p.z - bMin.z) / size.z) * nodeGrid), nodeGrid - 1);
+
+		uint cell = (((cz * nodeGrid) + cy) * nodeGrid) + cx;
+
+		if (!taken[cell]) {
+			taken[cell] = true;
+			kept.push_back(candidates[i]);
+			continue;
+		}
+		int octant =	((p.x >= centre.x) ? 1 : 0) |
+						((p.y >= centre.y) ? 2 : 0) |
+						((p.z >= centre.z) ? 4 : 0);
+
+		octants[octant].push_back(candidates[i]);
+	}
+	nodes[index].points.swap(kept);
+	vector<uint>().swap(candidates);	//Everything's been moved on, so free it
+
+	for (int o = 0; o < 8; ++o) {
+		if (octants[o].empty()) {
+			continue;
+		}
+		BuildNode child;
+		child.boundsMin = Vector3(	(o & 1) ? centre.x : bMin.x,
+									(o & 2) ? centre.y : bMin.y,
+									(o & 4) ? centre.z : bMin.z);
+		child.boundsMax = Vector3(	(o & 1) ? bMax.x : centre.x,
+									(o & 2) ? bMax.y : centre.y,
+									(o & 4) ? bMax.z : centre.z);
+		for (int c = 0; c < 8; ++c) {
+			child.children[c] = -1;
+		}
+		int childIndex = (int)nodes.size();
+		nodes.push_back(child);	//Careful - this can move the parent!
+
+		nodes[index].children[o] = childIndex;
+
+		BuildOctree(nodes, childIndex, octants[o], points, nodeGrid, depth + 1);
+	}
+}
+
+bool PointCloud::Build(const string &filename, const vector<Vector3> &points, const vector<Colour> &colours, uint nodeGrid) {
+	if (points.empty() || nodeGrid == 0 || (!colours.empty() && colours.size() != points.size())) {
+		return false;
+	}
+	Vector3 bMin = points[0];
+	Vector3 bMax = points[0];
+
+	for (size_t i = 1; i < points.size(); ++i) {
+		bMin = Vector3(min(bMin.x, points[i].x), min(bMin.y, points[i].y), min(bMin.z, points[i].z));
+		bMax = Vector3(max(bMax.x, points[i].x), max(bMax.y, points[i].y), max(bMax.z, points[i].z));
+	}
+	//The octree works best with cubes, so every node splits evenly
+	Vector3 size	= bMax - bMin;
+	float	extent	= max(max(max(size.x, size.y), size.z), 0.0001f);
+
+	BuildNode root;
+	root.boundsMin = bMin;
+	root.boundsMax = bMin + Vector3(extent, extent, extent);
+	for (int c = 0; c < 8; ++c) {
+		root.children[c] = -1;
+	}
+	vector<BuildNode> nodes;
+	nodes.push_back(root);
+
+	vector<uint> all(points.size());
+	for (size_t i = 0; i < points.size(); ++i) {
+		all[i] = (uint)i;
+	}
+	BuildOctree(nodes, 0, all, points, nodeGrid, 0);
+
+	std::ofstream file(filename.c_str(), std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	PointCloudHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.id, "PCLD", 4);
+	header.numNodes		= (unsigned int)nodes.size();
+	header.totalPoints	= points.size();
+
+	file.write((char*)&header, sizeof(header));
+
+	unsigned long long offset = sizeof(PointCloudHeader) + (nodes.size() * sizeof(PointCloudNodeRecord));
+
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		PointCloudNodeRecord r;
+		memset(&r, 0, sizeof(r));	//No stack garbage in the padding, please
+		r.boundsMin[0] = nodes[i].boundsMin.x;
+		r.boundsMin[1] = nodes[i].boundsMin.y;
+		r.boundsMin[2] = nodes[i].boundsMin.z;
+		r.boundsMax[0] = nodes[i].boundsMax.x;
+		r.boundsMax[1] = nodes[i].boundsMax.y;
+		r.boundsMax[2] = nodes[i].boundsMax.z;
+		memcpy(r.children, nodes[i].children, sizeof(r.children));
+		r.numPoints		= (unsigned int)nodes[i].points.size();
+		r.fileOffset	= offset;
+
+		file.write((char*)&r, sizeof(r));
+
+		offset += r.numPoints * sizeof(PointCloudPoint);
+	}
+
+	vector<PointCloudPoint> block;
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		const vector<uint> &indices = nodes[i].points;
+
+		block.resize(indices.size());
+		for (size_t j = 0; j < indices.size(); ++j) {
+			const Vector3 &p = points[indices[j]];
+			block[j].x		= p.x;
+			block[j].y		= p.y;
+			block[j].z		= p.z;
+			block[j].colour = colours.empty() ? Colour::White.c : colours[indices[j]].c;
+		}
+		if (!block.empty()) {
+			file.write((char*)&block[0], block.size() * sizeof(PointCloudPoint));
+		}
+	}
+	return !file.fail();
+}
+
+PointCloud::PointCloud(void) {
+	frame			= 1;	//0 means 'never used'
+	lodThreshold	= 128.0f;
+	quitLoader		= false;
+	requestRound	= 1;	//0 means 'never refused'
+	lastWanted		= 0;
+
+	memset(&stats, 0, sizeof(stats));
+}
+
+PointCloud::~PointCloud(void) {
+	if (loader.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(loaderMutex);
+			quitLoader = true;
+		}
+		loaderWake.notify_one();
+		loader.join();
+	}
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		delete nodes[i].points;
+	}
+	for (size_t i = 0; i < loaded.size(); ++i) {
+		delete loaded[i].points;
+	}
+}
+
+PointCloud* PointCloud::Open(const string &filename, size_t budgetBytes) {
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	if (!file.is_open()) {
+		return NULL;
+	}
+	PointCloudHeader header;
+	if (!file.read((char*)&header, sizeof(header)) || memcmp(header.id, "PCLD", 4) != 0 || header.numNodes == 0) {
+		return NULL;
+	}
+	vector<PointCloudNodeRecord> records(header.numNodes);
+	if (!file.read((char*)&records[0], records.size() * sizeof(PointCloudNodeRecord))) {
+		return NULL;
+	}
+	PointCloud* cloud = new PointCloud();
+	cloud->filename = filename;
+	cloud->nodes.resize(records.size());
+
+	for (size_t i = 0; i < records.size(); ++i) {
+		const PointCloudNodeRecord &r = records[i];
+		Node &n = cloud->nodes[i];
+
+		n.boundsMin		= Vector3(r.boundsMin[0], r.boundsMin[1], r.boundsMin[2]);
+		n.boundsMax		= Vector3(r.boundsMax[0], r.boundsMax[1], r.boundsMax[2]);
+		memcpy(n.children, r.children, sizeof(n.children));
+		n.numPoints		= r.numPoints;
+		n.fileOffset	= r.fileOffset;
+		n.points		= NULL;
+		n.lastUsed		= 0;
+		n.requested		= false;
+		n.refusedIn		= 0;
+	}
+	cloud->stats.budgetBytes	= budgetBytes;
+	cloud->stats.nodes			= header.numNodes;
+	cloud->stats.totalPoints	= header.totalPoints;
+
+	cloud->loader = std::thread(&PointCloud::LoaderThread, cloud);
+
+	return cloud;
+}
+
+void PointCloud::SetBudget(size_t bytes) {
+	stats.budgetBytes = bytes;
+	requestRound++;
+
+	if (stats.residentBytes > bytes) {
+		MakeRoom(0);
+	}
+}
+
+void PointCloud::NextFrame() {
+	frame++;
+
+	stats.nodesDrawn	= 0;
+	stats.pointsDrawn	= 0;
+}
+
+/*
+Runs on its own thread, for the lifetime of the cloud. It only ever reads the
+parts of a Node that don't change after Open - everything else is left to
+the main thread, which picks the finished nodes up in CollectLoaded.
+*/
+void PointCloud::LoaderThread() {
+	std::ifstream file(filename.c_str(), std::ios::binary);
+
+	vector<PointCloudPoint> block;
+
+	while (true) {
+		int index;
+		{
+			std::unique_lock<std::mutex> lock(loaderMutex);
+			while (!quitLoader && loadQueue.empty()) {
+				loaderWake.wait(lock);
+			}
+			if (quitLoader) {
+				return;
+			}
+			index = loadQueue.back();
+			loadQueue.pop_back();
+		}
+		const Node &n = nodes[index];
+
+		block.resize(n.numPoints);
+
+		file.clear();
+		file.seekg(n.fileOffset);
+
+		bool ok = n.numPoints > 0 && file.read((char*)&block[0], n.numPoints * sizeof(PointCloudPoint));
+
+		//Broken file? An empty node just leaves a gap, rather than us
+		//asking for it again every frame
+		LoadedNode l;
+		l.node		= index;
+		l.points	= Mesh::GenerateEmpty(PRIMITIVE_POINTS, ok ? n.numPoints : 0, VERTEX_POSITION | VERTEX_COLOUR);
+		if (!l.points) {	//Out of memory - that's a gap as well
+			ok			= false;
+			l.points	= Mesh::GenerateEmpty(PRIMITIVE_POINTS, 0, VERTEX_POSITION | VERTEX_COLOUR);
+		}
+
+		for (uint i = 0; ok && i < n.numPoints; ++i) {
+			Colour c;
+			c.c = block[i].colour;
+
+			l.points->SetPosition(i, Vector3(block[i].x, block[i].y, block[i].z));
+			l.points->SetColour(i, c);
+		}
+		std::lock_guard<std::mutex> lock(loaderMutex);
+		loaded.push_back(l);
+	}
+}
+
+void PointCloud::CollectLoaded() {
+	vector<LoadedNode> arrived;
+	{
+		std::lock_guard<std::mutex> lock(loaderMutex);
+		arrived.swap(loaded);
+	}
+	for (size_t i = 0; i < arrived.size(); ++i) {
+		Node &n = nodes[arrived[i].node];
+
+		n.requested = false;
+
+		if (n.points) {	//Asked for it twice, and got it twice
+			delete arrived[i].points;
+			continue;
+		}
+		//Unlike textures, we can always do without a node - if there's no
+		//room for it, it waits until the view changes, or something is freed
+		if (!MakeRoom(NodeBytes(n))) {
+			delete arrived[i].points;
+			n.refusedIn = requestRound;
+			continue;
+		}
+		n.points	= arrived[i].points;
+		n.lastUsed	= frame;
+
+		stats.residentBytes += NodeBytes(n);
+		stats.residentNodes++;
+		stats.nodeLoads++;
+
+		stats.peakResidentBytes = max(stats.peakResidentBytes, stats.residentBytes);
+	}
+}
+
+void PointCloud::RequestNodes(vector<std::pair<float, int> > &wanted) {
+	std::sort(wanted.begin(), wanted.end());	//Biggest ends up at the back
+
+	//The sizes change whenever the camera moves, but which nodes are wanted
+	//doesn't - so it's only the nodes that go into the hash, in any order
+	uint hash = (uint)wanted.size();
+	for (size_t i = 0; i < wanted.size(); ++i) {
+		hash += (uint)(wanted[i].second + 1) * 2654435761u;
+	}
+	if (hash != lastWanted) {
+		lastWanted = hash;
+		requestRound++;
+	}
+
+	std::lock_guard<std::mutex> lock(loaderMutex);
+
+	//Anything still queued from last time that we don't want any more can
+	//go, but whatever the loader is already working on will still arrive
+	for (size_t i = 0; i < loadQueue.size(); ++i) {
+		nodes[loadQueue[i]].requested = false;
+	}
+	loadQueue.clear();
+
+	for (size_t i = 0; i < wanted.size(); ++i) {
+		Node &n = nodes[wanted[i].second];
+		if (!n.requested && n.refusedIn != requestRound) {
+			n.requested = true;
+			loadQueue.push_back(wanted[i].second);
+		}
+	}
+	if (!loadQueue.empty()) {
+		loaderWake.notify_one();
+	}
+}
+
+/*
+Children are always written after their parents, so on a tie we throw away
+the later node - otherwise we could free a parent, and lose our way down to
+the children we were making room for.
+*/
+bool PointCloud::MakeRoom(size_t bytes) {
+	while (stats.residentBytes + bytes > stats.budgetBytes) {
+		int		oldest		= -1;
+		uint	oldestFrame = frame;
+
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			if (nodes[i].points && nodes[i].lastUsed < frame && nodes[i].lastUsed <= oldestFrame) {
+				oldest		= (int)i;
+				oldestFrame = nodes[i].lastUsed;
+			}
+		}
+		if (oldest < 0) {
+			return false; //Everything left is in use this frame
+		}
+		FreeNode(oldest);
+
+		stats.nodeEvictions++;
+	}
+	return true;
+}
+
+void PointCloud::FreeNode(int node) {
+	Node &n = nodes[node];
+
+	stats.residentBytes -= NodeBytes(n);
+	stats.residentNodes--;
+
+	delete n.points;
+	n.points = NULL;
+}
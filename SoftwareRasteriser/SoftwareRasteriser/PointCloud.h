@@ -0,0 +1,141 @@
+/******************************************************************************
+Class:PointCloud
+Implements:
+Description:A point cloud that's far too big to keep in memory, or to draw
+every point of every frame. Build writes the points out to an octree file -
+each node keeps an evenly spread sample of the points inside it, and passes
+the rest down to its children, so the root on its own is a coarse version of
+the whole cloud, and every level down adds more detail.
+
+Open only reads the node table. When the cloud is drawn, nodes are culled
+against the view, and only refined into their children while they're still
+bigger on screen than the LOD threshold. Nodes that are wanted but not loaded
+are handed to a loader thread, and drawn once they've arrived - until then we
+just see the coarser levels above them. As with the TextureManager, the least
+recently drawn nodes are thrown away when we go over budget.
+
+Call NextFrame once per frame, so that we know what's 'recently' used!
+
+-_-_-_-_-_-_-_,------,
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""
+
+*//////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Mesh.h"
+#include "Common.h"
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using std::vector;
+using std::string;
+
+struct PointCloudStats {
+	size_t	budgetBytes;
+	size_t	residentBytes;
+	size_t	peakResidentBytes;
+
+	uint	nodes;
+	uint	residentNodes;
+	unsigned long long totalPoints;
+
+	uint	nodeLoads;
+	uint	nodeEvictions;
+
+	uint	nodesDrawn;		//Just for the last frame
+	uint	pointsDrawn;
+};
+
+class PointCloud	{
+public:
+	friend class SoftwareRasteriser;
+
+	~PointCloud(void);
+
+	//Writes out an octree file for these points. Colours are optional, but
+	//if there are any, there must be one per point
+	static bool		Build(const string &filename, const vector<Vector3> &points,
+		const vector<Colour> &colours = vector<Colour>(), uint nodeGrid = 16);
+
+	//Reads the node table of a built cloud - no points are loaded yet
+	static PointCloud* Open(const string &filename, size_t budgetBytes);
+
+	void		SetBudget(size_t bytes);
+	size_t		GetBudget() { return stats.budgetBytes;}
+
+	//A node is refined into its children while it covers more than this
+	//many pixels on screen. Lower values draw more points
+	void		SetLODThreshold(float pixels) { lodThreshold = pixels;}
+	float		GetLODThreshold() { return lodThreshold;}
+
+	void		NextFrame();
+	uint		GetFrame() { return frame;}
+
+	const PointCloudStats& GetStats() { return stats;}
+
+protected:
+	PointCloud(void);
+
+	struct Node {
+		Vector3	boundsMin;
+		Vector3	boundsMax;
+		int		children[8];	//-1 if there isn't one
+
+		uint	numPoints;
+		unsigned long long fileOffset;
+
+		Mesh*		points;		//NULL until it's loaded
+		uint		lastUsed;
+		bool		requested;
+		uint		refusedIn;	//The requestRound there was no room for it in
+	};
+
+	struct LoadedNode {
+		int		node;
+		Mesh*	points;
+	};
+
+	static size_t NodeBytes(const Node &n) {
+		return n.numPoints * ((3 * sizeof(float)) + sizeof(Colour));
+	}
+
+	//Moves anything the loader has finished with into the cloud
+	void	CollectLoaded();
+
+	//Replaces the loader's queue with these nodes. They're sorted by how
+	//big they are on screen, so the most obvious gaps get filled first.
+	//Nodes there wasn't room for aren't asked for again until the budget,
+	//or the set of wanted nodes, changes - there'd still be no room
+	void	RequestNodes(vector<std::pair<float, int> > &wanted);
+
+	//Frees the least recently drawn nodes until 'bytes' more will fit. Nodes
+	//drawn this frame are never thrown away, so this can fail
+	bool	MakeRoom(size_t bytes);
+	void	FreeNode(int node);
+
+	void	LoaderThread();
+
+	vector<Node>	nodes;
+	string			filename;
+
+	std::thread				loader;
+	std::mutex				loaderMutex;
+	std::condition_variable	loaderWake;
+	vector<int>				loadQueue;	//Back of the queue is loaded first
+	vector<LoadedNode>		loaded;
+	bool					quitLoader;
+
+	uint	frame;
+	float	lodThreshold;
+
+	uint	requestRound;	//Goes up whenever the budget or wanted nodes change
+	uint	lastWanted;		//A hash of the last set of wanted nodes
+
+	PointCloudStats stats;
+};
@@ -1,11 +1,80 @@
-#include "RenderObject.h"
-
-
-RenderObject::RenderObject(void)	{
-	texture = NULL;
-	mesh	= NULL;
-}
-
-
-RenderObject::~RenderObject(void)	{
-}
+#include "RenderObject.h"
+
+
+RenderObject::RenderObject(void)	{
+	texture = NULL;
+	mesh	= NULL;
+	cloud	= NULL;
+	occluder = NULL;
+
+	lineMode	= LINE_SOLID;
+	lineWidth	= 1.0f;
+	pointSize	= 1.0f;
+	shadingRate	= SHADING_1X1;
+	changes		= 0;
+
+	transformed.x			= NULL;
+	transformed.y			= NULL;
+	transformed.z			= NULL;
+	transformed.invW		= NULL;
+	transformed.capacity	= 0;
+	transformed.mesh		= NULL;
+	transformed.changes		= 0;
+	transformed.valid		= false;
+}
+
+
+RenderObject::~RenderObject(void)	{
+	Mesh::FreeStream(transformed.x);
+	Mesh::FreeStream(transformed.y);
+	Mesh::FreeStream(transformed.z);
+	Mesh::FreeStream(transformed.invW);
+}
+
+//Grows the box from boxMin to boxMax so that it holds all of the box from
+//localMin to localMax, after it's been moved by m
+static void AddTransformedBox(const Matrix4 &m, const Vector3 &localMin, const Vector3 &localMax,
+	Vector3 &boxMin, Vector3 &boxMax, bool first) {
+	for (int i = 0; i < 8; ++i) {
+		Vector3 corner = m * Vector3(	(i & 1) ? localMax.x : localMin.x,
+										(i & 2) ? localMax.y : localMin.y,
+										(i & 4) ? localMax.z : localMin.z);
+		if (first && i == 0) {
+			boxMin = corner;
+			boxMax = corner;
+			continue;
+		}
+		boxMin.x = min(boxMin.x, corner.x);
+		boxMin.y = min(boxMin.y, corner.y);
+		boxMin.z = min(boxMin.z, corner.z);
+
+		boxMax.x = max(boxMax.x, corner.x);
+		boxMax.y = max(boxMax.y, corner.y);
+		boxMax.z = max(boxMax.z, corner.z);
+	}
+}
+
+/*
+A skinned vertex is a blend of where each of its bones would put it, so it's
+always inside the box around every bone's copy of the bind pose box. That's
+not very tight, but it's cheap, and it's never wrong.
+*/
+void RenderObject::GetModelBounds(Vector3 &boundsMin, Vector3 &boundsMax) const {
+	if (!mesh) {
+		boundsMin = Vector3();
+		boundsMax = Vector3();
+		return;
+	}
+	if (!IsSkinned()) {
+		boundsMin = mesh->GetBoundsMin();
+		boundsMax = mesh->GetBoundsMax();
+		return;
+	}
+	uint used = min((uint)bones.size(), mesh->GetNumBones());
+	for (uint b = 0; b < used; ++b) {
+		AddTransformedBox(bones[b], mesh->GetBoundsMin(), mesh->GetBoundsMax(), boundsMin, boundsMax, b == 0);
+	}
+	if (mesh->GetNumBones() > used) {
+		AddTransformedBox(Matrix4(), mesh->GetBoundsMin(), mesh->GetBoundsMax(), boundsMin, boundsMax, false);
+	}
+}
@@ -1,40 +1,112 @@
-/******************************************************************************
-Class:RenderObject
-Implements:
-Author:Rich Davison	<richard.davison4@newcastle.ac.uk>
-Description: Class to represent an object in our basic rendering program
-
--_-_-_-_-_-_-_,------,   
-_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
--_-_-_-_-_-_-~|__( ^ .^) /
-_-_-_-_-_-_-_-""  ""   
-
-*//////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "Mesh.h"
-#include "Texture.h"
-#include "Matrix4.h"
-
-class Texture;
-
-class RenderObject	{
-public:
-	RenderObject(void);
-	~RenderObject(void);
-
-	Mesh*	 GetMesh()	 { return mesh;}
-	Texture* GetTexure() { return texture;}
-
-	Matrix4 GetModelMatrix() {
-		return modelMatrix;
-	}
-
-//protected:
-	Matrix4 modelMatrix;
-
-	Texture*	texture;
-	Mesh*		mesh;
-};
-
+/******************************************************************************
+Class:RenderObject
+Implements:
+Author:Rich Davison	<richard.davison4@newcastle.ac.uk>
+Description: Class to represent an object in our basic rendering program
+
+-_-_-_-_-_-_-_,------,   
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""   
+
+*//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Mesh.h"
+#include "Texture.h"
+#include "Matrix4.h"
+#include "PointCloud.h"
+
+class Texture;
+
+//How the line primitives (lines, strips and loops) of an object are drawn
+enum LineMode {
+	LINE_SOLID,			//Single pixel steps, no blending
+	LINE_ANTIALIASED	//Blended by how much of each pixel the line covers
+};
+
+//How many pixels share each colour (or texture lookup) when filling in
+//triangles. Depth is always done per pixel, so edges stay sharp - it's just
+//the shading in between that goes blocky
+enum ShadingRate {
+	SHADING_1X1 = 1,
+	SHADING_2X2 = 2,
+	SHADING_4X4 = 4
+};
+
+/*
+A whole mesh's worth of screen space positions, from Matrix4::TransformBatch.
+Every object keeps its own, along with what they were worked out from, so an
+object that hasn't moved doesn't need transforming again until the camera
+does. They only ever grow, so we're not allocating every time either.
+*/
+struct TransformedVertices {
+	float*		x;
+	float*		y;
+	float*		z;
+	float*		invW;
+	uint		capacity;
+
+	Matrix4		matrix;		//Including the viewport transform
+	const Mesh*	mesh;
+	uint		changes;
+	bool		valid;
+};
+
+class RenderObject	{
+public:
+	RenderObject(void);
+	~RenderObject(void);
+
+	Mesh*	 GetMesh()	 { return mesh;}
+	Texture* GetTexure() { return texture;}
+
+	const Matrix4& GetModelMatrix() const {
+		return modelMatrix;
+	}
+
+	//Incremental rendering spots changes to everything here by itself, but
+	//not to what's inside the mesh or texture - call this if you edit them
+	void	MarkChanged()			{ ++changes;}
+	uint	GetChanges() const		{ return changes;}
+
+	//True if the mesh is skinned, and there are bones to move it with
+	bool	IsSkinned() const { return mesh && mesh->HasSkin() && !bones.empty();}
+
+	//The box around the mesh as it's drawn - for skinned meshes, that's
+	//wherever the bones have moved it to
+	void	GetModelBounds(Vector3 &boundsMin, Vector3 &boundsMax) const;
+
+	TransformedVertices&	GetTransformedVertices() { return transformed;}
+
+//protected:
+	Matrix4 modelMatrix;
+
+	Texture*	texture;
+	Mesh*		mesh;
+	PointCloud*	cloud;		//Drawn instead of the mesh, if there is one
+
+	//A simpler stand in for the mesh, for SoftwareRasteriser::DrawOccluder.
+	//It has to fit entirely inside the mesh, or it'll hide things it shouldn't!
+	Mesh*		occluder;
+
+	LineMode	lineMode;
+	float		lineWidth;	//In pixels - anything over 1 uses the span rasteriser
+	float		pointSize;	//In pixels - anything over 1 is drawn as a square splat
+	ShadingRate	shadingRate;
+
+	//Model space bone transforms, for skinned meshes. Bones the mesh uses that
+	//aren't in here are left where they are
+	vector<Matrix4>	bones;
+
+protected:
+	//These own the transformed vertex streams, so they can't be copied
+	RenderObject(const RenderObject &o);
+	RenderObject& operator=(const RenderObject &o);
+
+	uint		changes;
+
+	TransformedVertices	transformed;
+};
+
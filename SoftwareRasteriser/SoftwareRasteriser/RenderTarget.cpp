@@ -0,0 +1,26 @@
+#include "RenderTarget.h"
+
+RenderTarget::RenderTarget(uint width, uint height)	{
+	this->width		= max(1u, width);
+	this->height	= max(1u, height);
+
+	//Rows from the bottom of the view up, just like the screen - which is
+	//also how texture coordinates go, so it comes out the right way up
+	texture				= new Texture();
+	texture->width		= this->width;
+	texture->height		= this->height;
+	texture->mipLevels	= 1;
+	texture->AllocateLevels();
+
+	colour	= texture->levels[0];
+	depth	= new DepthTarget(this->width, this->height);
+
+	for (uint i = 0; i < this->width * this->height; ++i) {
+		colour[i] = Colour(0, 0, 0, 255);
+	}
+}
+
+RenderTarget::~RenderTarget(void)	{
+	delete texture;
+	delete depth;
+}
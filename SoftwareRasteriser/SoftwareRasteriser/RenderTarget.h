@@ -0,0 +1,54 @@
+/******************************************************************************
+Class:RenderTarget
+Implements:
+Description:Somewhere to draw other than the screen, with a colour and a depth
+buffer of its own, of whatever size you like. Bind one with
+SoftwareRasteriser::SetRenderTarget, and everything goes into it instead.
+
+The colour buffer is the texels of a Texture - we draw straight into them - so
+as soon as you've finished drawing, GetTexture can go on a RenderObject like
+any other, without copying anything. Handy for mirrors, minimaps, security
+cameras, and effects that take more than one pass.
+
+The texture only has the one mip level, so it looks best drawn at about the
+size it is. Don't change its layout or compress it, or it'll stop being
+something we can draw into! And incremental rendering can't tell that it's
+been drawn into, so call MarkChanged on anything using it when it has.
+
+-_-_-_-_-_-_-_,------,
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""
+
+*//////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Common.h"
+#include "Texture.h"
+#include "DepthTarget.h"
+
+class RenderTarget	{
+	friend class SoftwareRasteriser;
+public:
+	RenderTarget(uint width, uint height);
+	~RenderTarget(void);
+
+	uint	GetWidth()	const { return width;}
+	uint	GetHeight() const { return height;}
+
+	Texture*		GetTexture()		const { return texture;}
+	DepthTarget*	GetDepthTarget()	const { return depth;}
+
+protected:
+	uint			width;
+	uint			height;
+
+	Texture*		texture;
+	Colour*			colour;		//The texture's texels
+	DepthTarget*	depth;
+
+private:
+	//Owns its buffers, so can't be copied
+	RenderTarget(const RenderTarget &t);
+	RenderTarget& operator=(const RenderTarget &t);
+};
@@ -0,0 +1,141 @@
+#include "SIMDKernels.h"
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+bool			SIMDKernels::initialised	= false;
+SIMDLevel		SIMDKernels::level			= SIMD_SSE2;
+SIMDLevel		SIMDKernels::supported		= SIMD_SSE2;
+SIMDKernelTable	SIMDKernels::kernels;
+
+static void CPUID(int leaf, int subLeaf, unsigned int regs[4]) {
+#ifdef _MSC_VER
+	__cpuidex((int*)regs, leaf, subLeaf);
+#else
+	__cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+//Which register sets the OS saves on a task switch. It's no good the CPU
+//having AVX if the OS is going to trash the upper halves of the registers!
+static unsigned long long EnabledRegisterState() {
+#ifdef _MSC_VER
+	return _xgetbv(0);
+#else
+	unsigned int low, high;
+	__asm__ ("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+	return ((unsigned long long)high << 32) | low;
+#endif
+}
+
+SIMDLevel SIMDKernels::DetectLevel() {
+	unsigned int regs[4];	//eax, ebx, ecx, edx
+
+	CPUID(0, 0, regs);
+	unsigned int maxLeaf = regs[0];
+
+	CPUID(1, 0, regs);
+	unsigned int features = regs[2];
+
+	if (!(features & (1 << 19))) {	//SSE4.1
+		return SIMD_SSE2;
+	}
+	bool osSaves = (features & (1 << 27)) != 0;	//OSXSAVE
+	bool hasAVX	 = (features & (1 << 28)) != 0;
+	//The AVX2 kernels are built with /arch:AVX2, which lets the compiler
+	//use FMA instructions wherever it likes
+	bool hasFMA	 = (features & (1 << 12)) != 0;
+
+	if (!osSaves || !hasAVX || maxLeaf < 7) {
+		return SIMD_SSE41;
+	}
+	unsigned long long state = EnabledRegisterState();
+
+	if ((state & 0x6) != 0x6) {		//XMM and YMM
+		return SIMD_SSE41;
+	}
+	CPUID(7, 0, regs);
+	unsigned int extended = regs[1];
+
+	if (!(extended & (1 << 5)) || !hasFMA) {	//AVX2
+		return SIMD_SSE41;
+	}
+	if (!(extended & (1 << 16)) || (state & 0xE0) != 0xE0) {	//AVX-512F, and the ZMM state
+		return SIMD_AVX2;
+	}
+	return SIMD_AVX512;
+}
+
+SIMDLevel SIMDKernels::BuildTable(SIMDKernelTable &t, SIMDLevel upTo) {
+	bool (*setups[SIMD_MAX_LEVEL])(SIMDKernelTable &) = { SetupSSE2, SetupSSE41, SetupAVX2, SetupAVX512 };
+
+	//Start from the basics, and let each level replace what it can do better
+	SetupSSE2(t);
+
+	for (int i = SIMD_SSE41; i <= upTo; ++i) {
+		if (!setups[i](t)) {
+			return (SIMDLevel)(i - 1);
+		}
+	}
+	return upTo;
+}
+
+void SIMDKernels::Initialise() {
+	//Make sure the compiler could actually build everything the CPU can do
+	SIMDKernelTable scratch;
+	supported = BuildTable(scratch, DetectLevel());
+
+	SIMDLevel wanted = supported;
+
+	const char* forced = getenv("RASTERISER_SIMD");
+	if (forced) {
+		for (int i = 0; i < SIMD_MAX_LEVEL; ++i) {
+			if (strcmp(forced, LevelName((SIMDLevel)i)) == 0) {
+				wanted = (SIMDLevel)i;
+			}
+		}
+	}
+	//Only marked as done once the table's all there
+	level		= BuildTable(kernels, min(wanted, supported));
+	initialised = true;
+}
+
+//Fills the table in during static initialisation, before any threads exist
+static struct SIMDKernelsStartup {
+	SIMDKernelsStartup() {
+		SIMDKernels::GetLevel();
+	}
+} simdKernelsStartup;
+
+SIMDLevel SIMDKernels::GetLevel() {
+	Get();
+	return level;
+}
+
+SIMDLevel SIMDKernels::GetSupportedLevel() {
+	Get();
+	return supported;
+}
+
+SIMDLevel SIMDKernels::SetLevel(SIMDLevel newLevel) {
+	if (!initialised) {
+		Initialise();
+	}
+	level = BuildTable(kernels, min(newLevel, supported));
+	return level;
+}
+
+const char* SIMDKernels::LevelName(SIMDLevel l) {
+	switch (l) {
+		case SIMD_SSE2:		return "sse2";
+		case SIMD_SSE41:	return "sse4.1";
+		case SIMD_AVX2:		return "avx2";
+		case SIMD_AVX512:	return "avx512";
+		default:			return "unknown";
+	}
+}
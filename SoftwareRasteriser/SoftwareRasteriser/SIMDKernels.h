@@ -0,0 +1,188 @@
+/******************************************************************************
+Class:SIMDKernels
+Implements:
+Description:The rasteriser's hottest loops - clearing, finding the pixels a
+triangle covers, depth only spans, drawing and testing against occluders,
+transforming and skinning vertices, filtering texels and copying the frame out
+to the window - built once for each instruction set we care about, and picked
+at startup by asking the CPU what it can do. That way one exe can use AVX2 or
+AVX-512 where it's there, without crashing on older machines.
+
+Each instruction set gets its own SIMDKernels_XXX.cpp, which is the only file
+compiled with that instruction set turned on. They only fill in the kernels
+they actually have a better version of - everything else is inherited from
+the level below.
+
+Setting the environment variable RASTERISER_SIMD to sse2, sse4.1, avx2 or
+avx512 (or calling SetLevel) forces a lower level, which is handy for testing.
+You can't go above what the CPU supports, though!
+
+IMPORTANT: Don't include anything with (non static) inline functions in here,
+or in the kernel files - if the linker picks the AVX2 copy of some inline
+function to use everywhere, the whole program needs AVX2.
+
+-_-_-_-_-_-_-_,------,
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""
+
+*//////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Common.h"
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+enum SIMDLevel {
+	SIMD_SSE2,
+	SIMD_SSE41,
+	SIMD_AVX2,
+	SIMD_AVX512,
+	SIMD_MAX_LEVEL
+};
+
+//The same as VERTEX_BATCH_SIZE, so a batch never runs off the end of a stream
+#define POINT_BATCH_SIZE 8
+
+struct PointBatch {
+	float	x[POINT_BATCH_SIZE];
+	float	y[POINT_BATCH_SIZE];
+	float	depth[POINT_BATCH_SIZE];
+};
+
+//The same as MAX_VERTEX_BONES
+#define SKIN_BONES_PER_VERTEX 4
+
+//Anything outside of these, or behind the camera, is culled
+struct PointLimits {
+	float	minX;
+	float	maxX;
+	float	minY;
+	float	maxY;
+	float	maxDepth;
+};
+
+//Index of the lowest / highest set bit. The mask can't be 0!
+static inline int LowestBit(unsigned int mask) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+static inline int HighestBit(unsigned int mask) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse(&index, mask);
+	return (int)index;
+#else
+	return 31 - __builtin_clz(mask);
+#endif
+}
+
+//How many bits of the mask are set
+static inline int BitCount(unsigned int mask) {
+	int count = 0;
+	for (; mask; mask &= mask - 1) {
+		++count;
+	}
+	return count;
+}
+
+struct SIMDKernelTable {
+	//Fills 'count' pixels of a colour and a depth buffer
+	void	(*clearBuffers)(unsigned int* colour, unsigned short* depth, uint count,
+		unsigned int colourValue, unsigned short depthValue);
+
+	//Finds the first and last of 'count' pixels along a row that are inside
+	//a triangle, from the barycentric weights l1 and l2 at the start of the
+	//row, and how much they change per pixel. False if none of them are
+	bool	(*triangleSpan)(float l1, float l2, float l1dx, float l2dx, int count, int &first, int &last);
+
+	//Draws 'count' pixels along a row of an occluder triangle. A pixel is
+	//inside if all 3 edge functions are >= 0 there, and then its depth is
+	//pulled in to z, if that's nearer. Everything is given at the first pixel,
+	//along with how much it changes per pixel
+	void	(*occluderRow)(float* depth, int count, const float edges[3], const float edgesDx[3], float z, float zDx);
+
+	//True if any of 'count' occluder depths is at or behind 'depth'
+	bool	(*occluderTest)(const float* depths, int count, float depth);
+
+	//Depth tests (if 'test') and writes (if 'write') 'count' pixels of a row,
+	//starting at depth z and going up by zDx a pixel, exactly like
+	//SoftwareRasteriser::DepthFunc would. Returns how many passed
+	int		(*depthSpan)(unsigned short* depth, int count, float z, float zDx, bool test, bool write);
+
+	//See Matrix4::TransformBatch. m is column major, as Matrix4 stores it
+	void	(*transformVertices)(const float* m, const float* xs, const float* ys, const float* zs, uint count,
+		float* outX, float* outY, float* outZ, float* outInvW);
+
+	//The same as transformVertices, but each vertex is moved by a blend of up
+	//to 4 matrices from the palette (each of which should already include the
+	//projection and viewport), picked by a byte of its bone index each
+	void	(*skinVertices)(const float* palette, const float* xs, const float* ys, const float* zs,
+		const unsigned int* bones, const float* const weights[SKIN_BONES_PER_VERTEX], uint count,
+		float* outX, float* outY, float* outZ, float* outInvW);
+
+	//Transforms a batch of points (which all have w = 1) straight onto the
+	//screen, returning a bit per point that's inside the limits
+	int		(*transformPoints)(const float* xs, const float* ys, const float* zs, const float* m,
+		const PointLimits &l, PointBatch &out);
+
+	//Weights a 2x2 block of texels (top left, top right, bottom left, bottom
+	//right) by how far across and down the sample point is
+	__m128	(*bilinearFilter)(const unsigned int texels[4], float xAmount, float yAmount);
+
+	//Copies a finished frame to the window's buffer, which we never read back
+	void	(*presentBuffer)(unsigned int* dst, const unsigned int* src, uint count);
+};
+
+class SIMDKernels	{
+public:
+	//The table's filled in before main starts, so by the time there are any
+	//other threads (like the point cloud loader) this only ever reads. The
+	//check is just for anything that needs the kernels even earlier
+	static inline const SIMDKernelTable& Get() {
+		if (!initialised) {
+			Initialise();
+		}
+		return kernels;
+	}
+
+	static SIMDLevel	GetLevel();
+	//The best the CPU (and the compiler that built us) can do
+	static SIMDLevel	GetSupportedLevel();
+
+	//Switches to a different set of kernels, returning the level we actually
+	//got - asking for more than is supported gets the best there is. Nothing
+	//else can be using the kernels while this runs!
+	static SIMDLevel	SetLevel(SIMDLevel level);
+
+	static const char*	LevelName(SIMDLevel level);
+
+protected:
+	static void			Initialise();
+	static SIMDLevel	DetectLevel();
+
+	//Fills in t with the best kernels up to the given level, returning the
+	//level it actually managed to get to
+	static SIMDLevel	BuildTable(SIMDKernelTable &t, SIMDLevel upTo);
+
+	//Each of these lives in its own file, and is only called if the CPU has
+	//that instruction set. They return false if the compiler couldn't build
+	//them, in which case we stay on the level below.
+	static bool	SetupSSE2(SIMDKernelTable &t);
+	static bool	SetupSSE41(SIMDKernelTable &t);
+	static bool	SetupAVX2(SIMDKernelTable &t);
+	static bool	SetupAVX512(SIMDKernelTable &t);
+
+	static bool				initialised;
+	static SIMDLevel		level;
+	static SIMDLevel		supported;
+	static SIMDKernelTable	kernels;
+};
@@ -0,0 +1,286 @@
+/*
+AVX2 kernels - everything is done 8 wide. This is the only file that's built
+with /arch:AVX2, so nothing in here is ever run unless the CPU has it.
+*/
+#include "SIMDKernels.h"
+
+#if defined(__AVX2__) || defined(_MSC_VER)
+#include <immintrin.h>
+
+static void ClearBuffersAVX2(unsigned int* colour, unsigned short* depth, uint count,
+	unsigned int colourValue, unsigned short depthValue) {
+	__m256i c = _mm256_set1_epi32((int)colourValue);
+	__m256i d = _mm256_set1_epi16((short)depthValue);
+
+	uint i = 0;
+	for (; i + 16 <= count; i += 16) {
+		_mm256_storeu_si256((__m256i*)(colour + i),		c);
+		_mm256_storeu_si256((__m256i*)(colour + i + 8), c);
+		_mm256_storeu_si256((__m256i*)(depth + i),		d);
+	}
+	for (; i < count; ++i) {
+		colour[i]	= colourValue;
+		depth[i]	= depthValue;
+	}
+}
+
+static inline int InsideMask8(const __m256 &l1, const __m256 &l2, const __m256 &l1dx, const __m256 &l2dx, int start, int count) {
+	__m256 x = _mm256_add_ps(_mm256_set1_ps((float)start), _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f));
+
+	__m256 a = _mm256_add_ps(l1, _mm256_mul_ps(x, l1dx));
+	__m256 b = _mm256_add_ps(l2, _mm256_mul_ps(x, l2dx));
+
+	__m256 inside = _mm256_and_ps(_mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_GE_OQ),
+								  _mm256_cmp_ps(b, _mm256_setzero_ps(), _CMP_GE_OQ));
+	inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(a, b), _mm256_set1_ps(1.0f), _CMP_LE_OQ));
+
+	int mask = _mm256_movemask_ps(inside);
+	if (count - start < 8) {
+		mask &= (1 << (count - start)) - 1;
+	}
+	return mask;
+}
+
+static bool TriangleSpanAVX2(float l1, float l2, float l1dx, float l2dx, int count, int &first, int &last) {
+	__m256 a	= _mm256_set1_ps(l1);
+	__m256 b	= _mm256_set1_ps(l2);
+	__m256 adx	= _mm256_set1_ps(l1dx);
+	__m256 bdx	= _mm256_set1_ps(l2dx);
+
+	int start = 0;
+	for (; start < count; start += 8) {
+		int mask = InsideMask8(a, b, adx, bdx, start, count);
+		if (mask) {
+			first = start + LowestBit(mask);
+			break;
+		}
+	}
+	if (start >= count) {
+		return false;
+	}
+	for (int end = (count - 1) & ~7; end >= start; end -= 8) {
+		int mask = InsideMask8(a, b, adx, bdx, end, count);
+		if (mask) {
+			last = end + HighestBit(mask);
+			break;
+		}
+	}
+	return true;
+}
+
+static void OccluderRowAVX2(float* depth, int count, const float edges[3], const float edgesDx[3], float z, float zDx) {
+	__m256 e0	= _mm256_set1_ps(edges[0]);
+	__m256 e1	= _mm256_set1_ps(edges[1]);
+	__m256 e2	= _mm256_set1_ps(edges[2]);
+	__m256 e0dx = _mm256_set1_ps(edgesDx[0]);
+	__m256 e1dx = _mm256_set1_ps(edgesDx[1]);
+	__m256 e2dx = _mm256_set1_ps(edgesDx[2]);
+	__m256 d	= _mm256_set1_ps(z);
+	__m256 ddx	= _mm256_set1_ps(zDx);
+	__m256 zero = _mm256_setzero_ps();
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256 x = _mm256_add_ps(_mm256_set1_ps((float)i), _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f));
+
+		__m256 inside = _mm256_cmp_ps(_mm256_add_ps(e0, _mm256_mul_ps(x, e0dx)), zero, _CMP_GE_OQ);
+		inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(e1, _mm256_mul_ps(x, e1dx)), zero, _CMP_GE_OQ));
+		inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(e2, _mm256_mul_ps(x, e2dx)), zero, _CMP_GE_OQ));
+
+		__m256 old		= _mm256_loadu_ps(depth + i);
+		__m256 nearest	= _mm256_min_ps(old, _mm256_add_ps(d, _mm256_mul_ps(x, ddx)));
+
+		_mm256_storeu_ps(depth + i, _mm256_blendv_ps(old, nearest, inside));
+	}
+	for (; i < count; ++i) {
+		float x = (float)i;
+		if (edges[0] + x * edgesDx[0] >= 0.0f &&
+			edges[1] + x * edgesDx[1] >= 0.0f &&
+			edges[2] + x * edgesDx[2] >= 0.0f) {
+			depth[i] = min(depth[i], z + x * zDx);
+		}
+	}
+}
+
+static bool OccluderTestAVX2(const float* depths, int count, float depth) {
+	__m256 d = _mm256_set1_ps(depth);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(depths + i), d, _CMP_GE_OQ))) {
+			return true;
+		}
+	}
+	for (; i < count; ++i) {
+		if (depths[i] >= depth) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//The same as DepthSpanSSE2, 8 at a time
+static int DepthSpanAVX2(unsigned short* depth, int count, float z, float zDx, bool test, bool write) {
+	__m256	d		= _mm256_set1_ps(z);
+	__m256	ddx		= _mm256_set1_ps(zDx);
+	__m256i zero	= _mm256_setzero_si256();
+	__m256i all		= _mm256_set1_epi32(-1);
+
+	int passed	= 0;
+	int i		= 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256	x		= _mm256_add_ps(_mm256_set1_ps((float)i), _mm256_set_ps(7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f));
+		__m256i value	= _mm256_cvttps_epi32(_mm256_add_ps(d, _mm256_mul_ps(x, ddx)));
+		__m256i old		= _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(depth + i)));
+
+		__m256i pass = all;
+		if (test) {
+			pass = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi32(value, old), _mm256_cmpgt_epi32(zero, value)), all);
+		}
+		int mask = _mm256_movemask_ps(_mm256_castsi256_ps(pass));
+		if (!mask) {
+			continue;
+		}
+		passed += BitCount(mask);
+
+		if (write) {
+			__m256i result = _mm256_blendv_epi8(old, value, pass);
+			result = _mm256_srai_epi32(_mm256_slli_epi32(result, 16), 16);
+			_mm_storeu_si128((__m128i*)(depth + i),
+				_mm_packs_epi32(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1)));
+		}
+	}
+	//This file's built with /fp:strict, so this can't get turned into an FMA,
+	//and round differently to the other kernels (and the colour pass)
+	for (; i < count; ++i) {
+		unsigned int value = (unsigned int)(z + (float)i * zDx);
+		if (test && value > depth[i]) {
+			continue;
+		}
+		++passed;
+		if (write) {
+			depth[i] = (unsigned short)value;
+		}
+	}
+	return passed;
+}
+
+static void TransformVerticesAVX2(const float* mat, const float* xs, const float* ys, const float* zs, uint count,
+	float* outX, float* outY, float* outZ, float* outInvW) {
+	__m256 m[16];
+	for (int i = 0; i < 16; ++i) {
+		m[i] = _mm256_set1_ps(mat[i]);
+	}
+	__m256 one	= _mm256_set1_ps(1.0f);
+	__m256 zero = _mm256_setzero_ps();
+
+	for (uint i = 0; i < count; i += 8) {
+		__m256 x = _mm256_load_ps(xs + i);
+		__m256 y = _mm256_load_ps(ys + i);
+		__m256 z = _mm256_load_ps(zs + i);
+
+		__m256 cx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[0]), _mm256_mul_ps(y, m[4])), _mm256_mul_ps(z, m[8])),  m[12]);
+		__m256 cy = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[1]), _mm256_mul_ps(y, m[5])), _mm256_mul_ps(z, m[9])),  m[13]);
+		__m256 cz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[2]), _mm256_mul_ps(y, m[6])), _mm256_mul_ps(z, m[10])), m[14]);
+		__m256 cw = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[3]), _mm256_mul_ps(y, m[7])), _mm256_mul_ps(z, m[11])), m[15]);
+
+		__m256 invW = _mm256_and_ps(_mm256_div_ps(one, cw), _mm256_cmp_ps(cw, zero, _CMP_GT_OQ));
+
+		_mm256_store_ps(outX + i,	 _mm256_mul_ps(cx, invW));
+		_mm256_store_ps(outY + i,	 _mm256_mul_ps(cy, invW));
+		_mm256_store_ps(outZ + i,	 _mm256_mul_ps(cz, invW));
+		_mm256_store_ps(outInvW + i, invW);
+	}
+}
+
+static inline __m256 TransformRow8(__m256 x, __m256 y, __m256 z, const float* m, int row) {
+	return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(m[row])),	 _mm256_mul_ps(y, _mm256_set1_ps(m[row + 4]))),
+						 _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(m[row + 8])), _mm256_set1_ps(m[row + 12])));
+}
+
+//A whole batch in one go
+static int TransformPointsAVX2(const float* xs, const float* ys, const float* zs, const float* m,
+	const PointLimits &l, PointBatch &out) {
+	__m256 x = _mm256_load_ps(xs);
+	__m256 y = _mm256_load_ps(ys);
+	__m256 z = _mm256_load_ps(zs);
+
+	__m256 cx = TransformRow8(x, y, z, m, 0);
+	__m256 cy = TransformRow8(x, y, z, m, 1);
+	__m256 cz = TransformRow8(x, y, z, m, 2);
+	__m256 cw = TransformRow8(x, y, z, m, 3);
+
+	__m256 recip = _mm256_div_ps(_mm256_set1_ps(1.0f), cw);
+
+	__m256 sx = _mm256_mul_ps(cx, recip);
+	__m256 sy = _mm256_mul_ps(cy, recip);
+	__m256 sz = _mm256_mul_ps(cz, recip);
+
+	__m256 inside = _mm256_cmp_ps(cw, _mm256_setzero_ps(), _CMP_GT_OQ);
+	inside = _mm256_and_ps(inside, _mm256_cmp_ps(sx, _mm256_set1_ps(l.minX), _CMP_GE_OQ));
+	inside = _mm256_and_ps(inside, _mm256_cmp_ps(sx, _mm256_set1_ps(l.maxX), _CMP_LT_OQ));
+	inside = _mm256_and_ps(inside, _mm256_cmp_ps(sy, _mm256_set1_ps(l.minY), _CMP_GE_OQ));
+	inside = _mm256_and_ps(inside, _mm256_cmp_ps(sy, _mm256_set1_ps(l.maxY), _CMP_LT_OQ));
+	inside = _mm256_and_ps(inside, _mm256_cmp_ps(sz, _mm256_setzero_ps(), _CMP_GE_OQ));
+	inside = _mm256_and_ps(inside, _mm256_cmp_ps(sz, _mm256_set1_ps(l.maxDepth), _CMP_LE_OQ));
+
+	_mm256_storeu_ps(out.x, sx);
+	_mm256_storeu_ps(out.y, sy);
+	_mm256_storeu_ps(out.depth, sz);
+
+	return _mm256_movemask_ps(inside);
+}
+
+//Two texels per register, so the top and bottom rows are weighted in one
+//multiply each. They're still summed in the same order as the SSE versions.
+static __m128 BilinearFilterAVX2(const unsigned int texels[4], float xAmount, float yAmount) {
+	__m256 top		= _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)texels)));
+	__m256 bottom	= _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(texels + 2))));
+
+	__m256 topWeights = _mm256_insertf128_ps(_mm256_castps128_ps256(
+		_mm_set1_ps((1.0f - xAmount) * (1.0f - yAmount))), _mm_set1_ps(xAmount * (1.0f - yAmount)), 1);
+	__m256 bottomWeights = _mm256_insertf128_ps(_mm256_castps128_ps256(
+		_mm_set1_ps((1.0f - xAmount) * yAmount)), _mm_set1_ps(xAmount * yAmount), 1);
+
+	top		= _mm256_mul_ps(top, topWeights);
+	bottom	= _mm256_mul_ps(bottom, bottomWeights);
+
+	__m128 result = _mm_add_ps(_mm256_castps256_ps128(top), _mm256_extractf128_ps(top, 1));
+	result = _mm_add_ps(result, _mm256_castps256_ps128(bottom));
+	result = _mm_add_ps(result, _mm256_extractf128_ps(bottom, 1));
+
+	return result;
+}
+
+static void PresentBufferAVX2(unsigned int* dst, const unsigned int* src, uint count) {
+	uint i = 0;
+	for (; i < count && ((size_t)(dst + i) & 31); ++i) {
+		dst[i] = src[i];
+	}
+	for (; i + 8 <= count; i += 8) {
+		_mm256_stream_si256((__m256i*)(dst + i), _mm256_loadu_si256((const __m256i*)(src + i)));
+	}
+	for (; i < count; ++i) {
+		dst[i] = src[i];
+	}
+	_mm_sfence();
+}
+
+bool SIMDKernels::SetupAVX2(SIMDKernelTable &t) {
+	t.clearBuffers		= ClearBuffersAVX2;
+	t.triangleSpan		= TriangleSpanAVX2;
+	t.occluderRow		= OccluderRowAVX2;
+	t.occluderTest		= OccluderTestAVX2;
+	t.depthSpan			= DepthSpanAVX2;
+	t.transformVertices = TransformVerticesAVX2;
+	t.transformPoints	= TransformPointsAVX2;
+	t.bilinearFilter	= BilinearFilterAVX2;
+	t.presentBuffer		= PresentBufferAVX2;
+	return true;
+}
+
+#else
+bool SIMDKernels::SetupAVX2(SIMDKernelTable &t) {
+	return false;
+}
+#endif
@@ -0,0 +1,151 @@
+/*
+AVX-512 kernels, 16 wide. Visual Studio only knows about these intrinsics
+from 2017 (15.3) onwards, so older compilers just don't build them, and we
+stay on AVX2. Point batches are only 8 long, so they keep the AVX2 kernel.
+Like the AVX2 file, it's built with /fp:strict, so the scalar tails can't be
+turned into FMAs and give different results to the other levels.
+*/
+#include "SIMDKernels.h"
+
+#if defined(__AVX512F__) || (defined(_MSC_VER) && _MSC_VER >= 1911)
+#include <immintrin.h>
+
+static void ClearBuffersAVX512(unsigned int* colour, unsigned short* depth, uint count,
+	unsigned int colourValue, unsigned short depthValue) {
+	__m512i c = _mm512_set1_epi32((int)colourValue);
+	__m512i d = _mm512_set1_epi16((short)depthValue);
+
+	uint i = 0;
+	for (; i + 32 <= count; i += 32) {
+		_mm512_storeu_si512(colour + i,		 c);
+		_mm512_storeu_si512(colour + i + 16, c);
+		_mm512_storeu_si512(depth + i,		 d);
+	}
+	for (; i < count; ++i) {
+		colour[i]	= colourValue;
+		depth[i]	= depthValue;
+	}
+}
+
+static inline int InsideMask16(const __m512 &l1, const __m512 &l2, const __m512 &l1dx, const __m512 &l2dx, int start, int count) {
+	__m512 x = _mm512_add_ps(_mm512_set1_ps((float)start), _mm512_set_ps(
+		15.0f, 14.0f, 13.0f, 12.0f, 11.0f, 10.0f, 9.0f, 8.0f, 7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f, 0.0f));
+
+	__m512 a = _mm512_add_ps(l1, _mm512_mul_ps(x, l1dx));
+	__m512 b = _mm512_add_ps(l2, _mm512_mul_ps(x, l2dx));
+
+	__mmask16 inside = _mm512_cmp_ps_mask(a, _mm512_setzero_ps(), _CMP_GE_OQ);
+	inside = _mm512_mask_cmp_ps_mask(inside, b, _mm512_setzero_ps(), _CMP_GE_OQ);
+	inside = _mm512_mask_cmp_ps_mask(inside, _mm512_add_ps(a, b), _mm512_set1_ps(1.0f), _CMP_LE_OQ);
+
+	int mask = (int)inside;
+	if (count - start < 16) {
+		mask &= (1 << (count - start)) - 1;
+	}
+	return mask;
+}
+
+static bool TriangleSpanAVX512(float l1, float l2, float l1dx, float l2dx, int count, int &first, int &last) {
+	__m512 a	= _mm512_set1_ps(l1);
+	__m512 b	= _mm512_set1_ps(l2);
+	__m512 adx	= _mm512_set1_ps(l1dx);
+	__m512 bdx	= _mm512_set1_ps(l2dx);
+
+	int start = 0;
+	for (; start < count; start += 16) {
+		int mask = InsideMask16(a, b, adx, bdx, start, count);
+		if (mask) {
+			first = start + LowestBit(mask);
+			break;
+		}
+	}
+	if (start >= count) {
+		return false;
+	}
+	for (int end = (count - 1) & ~15; end >= start; end -= 16) {
+		int mask = InsideMask16(a, b, adx, bdx, end, count);
+		if (mask) {
+			last = end + HighestBit(mask);
+			break;
+		}
+	}
+	return true;
+}
+
+//Streams are only padded out to 8, so the last batch might only be half full
+static void TransformVerticesAVX512(const float* mat, const float* xs, const float* ys, const float* zs, uint count,
+	float* outX, float* outY, float* outZ, float* outInvW) {
+	__m512 m[16];
+	for (int i = 0; i < 16; ++i) {
+		m[i] = _mm512_set1_ps(mat[i]);
+	}
+	__m512 one	= _mm512_set1_ps(1.0f);
+	__m512 zero = _mm512_setzero_ps();
+
+	for (uint i = 0; i < count; i += 16) {
+		__mmask16 lanes = (count - i > 8) ? 0xFFFF : 0x00FF;
+
+		__m512 x = _mm512_maskz_loadu_ps(lanes, xs + i);
+		__m512 y = _mm512_maskz_loadu_ps(lanes, ys + i);
+		__m512 z = _mm512_maskz_loadu_ps(lanes, zs + i);
+
+		__m512 cx = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(x, m[0]), _mm512_mul_ps(y, m[4])), _mm512_mul_ps(z, m[8])),  m[12]);
+		__m512 cy = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(x, m[1]), _mm512_mul_ps(y, m[5])), _mm512_mul_ps(z, m[9])),  m[13]);
+		__m512 cz = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(x, m[2]), _mm512_mul_ps(y, m[6])), _mm512_mul_ps(z, m[10])), m[14]);
+		__m512 cw = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(x, m[3]), _mm512_mul_ps(y, m[7])), _mm512_mul_ps(z, m[11])), m[15]);
+
+		__m512 invW = _mm512_maskz_div_ps(_mm512_cmp_ps_mask(cw, zero, _CMP_GT_OQ), one, cw);
+
+		_mm512_mask_storeu_ps(outX + i,		lanes, _mm512_mul_ps(cx, invW));
+		_mm512_mask_storeu_ps(outY + i,		lanes, _mm512_mul_ps(cy, invW));
+		_mm512_mask_storeu_ps(outZ + i,		lanes, _mm512_mul_ps(cz, invW));
+		_mm512_mask_storeu_ps(outInvW + i,	lanes, invW);
+	}
+}
+
+//All 4 texels at once. Summed in the same order as the SSE versions
+static __m128 BilinearFilterAVX512(const unsigned int texels[4], float xAmount, float yAmount) {
+	__m512 quad = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)texels)));
+
+	float tl = (1.0f - xAmount) * (1.0f - yAmount);
+	float tr = xAmount * (1.0f - yAmount);
+	float bl = (1.0f - xAmount) * yAmount;
+	float br = xAmount * yAmount;
+
+	quad = _mm512_mul_ps(quad, _mm512_set_ps(br, br, br, br, bl, bl, bl, bl, tr, tr, tr, tr, tl, tl, tl, tl));
+
+	__m128 result = _mm_add_ps(_mm512_extractf32x4_ps(quad, 0), _mm512_extractf32x4_ps(quad, 1));
+	result = _mm_add_ps(result, _mm512_extractf32x4_ps(quad, 2));
+	result = _mm_add_ps(result, _mm512_extractf32x4_ps(quad, 3));
+
+	return result;
+}
+
+static void PresentBufferAVX512(unsigned int* dst, const unsigned int* src, uint count) {
+	uint i = 0;
+	for (; i < count && ((size_t)(dst + i) & 63); ++i) {
+		dst[i] = src[i];
+	}
+	for (; i + 16 <= count; i += 16) {
+		_mm512_stream_si512((__m512i*)(dst + i), _mm512_loadu_si512(src + i));
+	}
+	for (; i < count; ++i) {
+		dst[i] = src[i];
+	}
+	_mm_sfence();
+}
+
+bool SIMDKernels::SetupAVX512(SIMDKernelTable &t) {
+	t.clearBuffers		= ClearBuffersAVX512;
+	t.triangleSpan		= TriangleSpanAVX512;
+	t.transformVertices = TransformVerticesAVX512;
+	t.bilinearFilter	= BilinearFilterAVX512;
+	t.presentBuffer		= PresentBufferAVX512;
+	return true;
+}
+
+#else
+bool SIMDKernels::SetupAVX512(SIMDKernelTable &t) {
+	return false;
+}
+#endif
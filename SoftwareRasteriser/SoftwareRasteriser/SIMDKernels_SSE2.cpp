@@ -0,0 +1,338 @@
+/*
+The baseline kernels. Every x86 CPU we'll ever run on has SSE2, so this is
+what everything falls back to.
+*/
+#include "SIMDKernels.h"
+
+static void ClearBuffersSSE2(unsigned int* colour, unsigned short* depth, uint count,
+	unsigned int colourValue, unsigned short depthValue) {
+	__m128i c = _mm_set1_epi32((int)colourValue);
+	__m128i d = _mm_set1_epi16((short)depthValue);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		_mm_storeu_si128((__m128i*)(colour + i),	 c);
+		_mm_storeu_si128((__m128i*)(colour + i + 4), c);
+		_mm_storeu_si128((__m128i*)(depth + i),		 d);
+	}
+	for (; i < count; ++i) {
+		colour[i]	= colourValue;
+		depth[i]	= depthValue;
+	}
+}
+
+//A bit per pixel that's inside the triangle, for the 4 pixels from 'start'.
+//Each pixel's weights are worked out from the start of the row, rather than
+//stepped along, so every kernel width gets exactly the same answer. The
+//vectors are passed by reference, as 32 bit MSVC can only pass 3 by value
+static inline int InsideMask4(const __m128 &l1, const __m128 &l2, const __m128 &l1dx, const __m128 &l2dx, int start, int count) {
+	__m128 x = _mm_add_ps(_mm_set1_ps((float)start), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f));
+
+	__m128 a = _mm_add_ps(l1, _mm_mul_ps(x, l1dx));
+	__m128 b = _mm_add_ps(l2, _mm_mul_ps(x, l2dx));
+
+	__m128 inside = _mm_and_ps(_mm_cmpge_ps(a, _mm_setzero_ps()), _mm_cmpge_ps(b, _mm_setzero_ps()));
+	inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_add_ps(a, b), _mm_set1_ps(1.0f)));
+
+	int mask = _mm_movemask_ps(inside);
+	if (count - start < 4) {
+		mask &= (1 << (count - start)) - 1;
+	}
+	return mask;
+}
+
+static bool TriangleSpanSSE2(float l1, float l2, float l1dx, float l2dx, int count, int &first, int &last) {
+	__m128 a	= _mm_set1_ps(l1);
+	__m128 b	= _mm_set1_ps(l2);
+	__m128 adx	= _mm_set1_ps(l1dx);
+	__m128 bdx	= _mm_set1_ps(l2dx);
+
+	int start = 0;
+	for (; start < count; start += 4) {
+		int mask = InsideMask4(a, b, adx, bdx, start, count);
+		if (mask) {
+			first = start + LowestBit(mask);
+			break;
+		}
+	}
+	if (start >= count) {
+		return false;
+	}
+	//Triangles are convex, so everything in between is inside too
+	for (int end = (count - 1) & ~3; end >= start; end -= 4) {
+		int mask = InsideMask4(a, b, adx, bdx, end, count);
+		if (mask) {
+			last = end + HighestBit(mask);
+			break;
+		}
+	}
+	return true;
+}
+
+//Like InsideMask4, each pixel's values come straight from the start of the row
+static void OccluderRowSSE2(float* depth, int count, const float edges[3], const float edgesDx[3], float z, float zDx) {
+	__m128 e0	= _mm_set1_ps(edges[0]);
+	__m128 e1	= _mm_set1_ps(edges[1]);
+	__m128 e2	= _mm_set1_ps(edges[2]);
+	__m128 e0dx = _mm_set1_ps(edgesDx[0]);
+	__m128 e1dx = _mm_set1_ps(edgesDx[1]);
+	__m128 e2dx = _mm_set1_ps(edgesDx[2]);
+	__m128 d	= _mm_set1_ps(z);
+	__m128 ddx	= _mm_set1_ps(zDx);
+	__m128 zero = _mm_setzero_ps();
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128 x = _mm_add_ps(_mm_set1_ps((float)i), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f));
+
+		__m128 inside = _mm_cmpge_ps(_mm_add_ps(e0, _mm_mul_ps(x, e0dx)), zero);
+		inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(e1, _mm_mul_ps(x, e1dx)), zero));
+		inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(e2, _mm_mul_ps(x, e2dx)), zero));
+
+		__m128 old		= _mm_loadu_ps(depth + i);
+		__m128 nearest	= _mm_min_ps(old, _mm_add_ps(d, _mm_mul_ps(x, ddx)));
+
+		_mm_storeu_ps(depth + i, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, old)));
+	}
+	for (; i < count; ++i) {
+		float x = (float)i;
+		if (edges[0] + x * edgesDx[0] >= 0.0f &&
+			edges[1] + x * edgesDx[1] >= 0.0f &&
+			edges[2] + x * edgesDx[2] >= 0.0f) {
+			depth[i] = min(depth[i], z + x * zDx);
+		}
+	}
+}
+
+static bool OccluderTestSSE2(const float* depths, int count, float depth) {
+	__m128 d = _mm_set1_ps(depth);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(depths + i), d))) {
+			return true;
+		}
+	}
+	for (; i < count; ++i) {
+		if (depths[i] >= depth) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+There's no unsigned 16 bit compare until SSE4.1, so depths are widened to 32
+bits first. Depths that were negative would come out of DepthFunc's cast as
+huge, so they fail the test here too. Only the bottom 16 bits of each depth
+are written (again like the cast), which the shifts sign extend so the pack
+back down doesn't saturate them.
+*/
+static int DepthSpanSSE2(unsigned short* depth, int count, float z, float zDx, bool test, bool write) {
+	__m128	d		= _mm_set1_ps(z);
+	__m128	ddx		= _mm_set1_ps(zDx);
+	__m128i zero	= _mm_setzero_si128();
+	__m128i all		= _mm_set1_epi32(-1);
+
+	int passed	= 0;
+	int i		= 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128	x		= _mm_add_ps(_mm_set1_ps((float)i), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f));
+		__m128i value	= _mm_cvttps_epi32(_mm_add_ps(d, _mm_mul_ps(x, ddx)));
+		__m128i old		= _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)(depth + i)), zero);
+
+		__m128i pass = all;
+		if (test) {
+			pass = _mm_andnot_si128(_mm_or_si128(_mm_cmpgt_epi32(value, old), _mm_cmplt_epi32(value, zero)), all);
+		}
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(pass));
+		if (!mask) {
+			continue;
+		}
+		passed += BitCount(mask);
+
+		if (write) {
+			__m128i result = _mm_or_si128(_mm_and_si128(pass, value), _mm_andnot_si128(pass, old));
+			result = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+			_mm_storel_epi64((__m128i*)(depth + i), _mm_packs_epi32(result, result));
+		}
+	}
+	for (; i < count; ++i) {
+		unsigned int value = (unsigned int)(z + (float)i * zDx);
+		if (test && value > depth[i]) {
+			continue;
+		}
+		++passed;
+		if (write) {
+			depth[i] = (unsigned short)value;
+		}
+	}
+	return passed;
+}
+
+static void TransformVerticesSSE2(const float* mat, const float* xs, const float* ys, const float* zs, uint count,
+	float* outX, float* outY, float* outZ, float* outInvW) {
+	__m128 m[16];
+	for (int i = 0; i < 16; ++i) {
+		m[i] = _mm_set1_ps(mat[i]);
+	}
+	__m128 one	= _mm_set1_ps(1.0f);
+	__m128 zero = _mm_setzero_ps();
+
+	for (uint i = 0; i < count; i += 4) {
+		__m128 x = _mm_load_ps(xs + i);
+		__m128 y = _mm_load_ps(ys + i);
+		__m128 z = _mm_load_ps(zs + i);
+
+		__m128 cx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0]), _mm_mul_ps(y, m[4])), _mm_mul_ps(z, m[8])),	m[12]);
+		__m128 cy = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[1]), _mm_mul_ps(y, m[5])), _mm_mul_ps(z, m[9])),	m[13]);
+		__m128 cz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[2]), _mm_mul_ps(y, m[6])), _mm_mul_ps(z, m[10])), m[14]);
+		__m128 cw = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[3]), _mm_mul_ps(y, m[7])), _mm_mul_ps(z, m[11])), m[15]);
+
+		__m128 invW = _mm_and_ps(_mm_div_ps(one, cw), _mm_cmpgt_ps(cw, zero));
+
+		_mm_store_ps(outX + i,	  _mm_mul_ps(cx, invW));
+		_mm_store_ps(outY + i,	  _mm_mul_ps(cy, invW));
+		_mm_store_ps(outZ + i,	  _mm_mul_ps(cz, invW));
+		_mm_store_ps(outInvW + i, invW);
+	}
+}
+
+//Each vertex blends its bones' matrices together a column at a time, then
+//goes through the result just like in TransformVerticesSSE2. Vertices can all
+//use different bones, so there's no batching them up - and wider registers
+//don't help, which is why this is the only version
+static void SkinVerticesSSE2(const float* palette, const float* xs, const float* ys, const float* zs,
+	const unsigned int* bones, const float* const weights[SKIN_BONES_PER_VERTEX], uint count,
+	float* outX, float* outY, float* outZ, float* outInvW) {
+	for (uint i = 0; i < count; ++i) {
+		__m128 c0 = _mm_setzero_ps();
+		__m128 c1 = _mm_setzero_ps();
+		__m128 c2 = _mm_setzero_ps();
+		__m128 c3 = _mm_setzero_ps();
+
+		for (int b = 0; b < SKIN_BONES_PER_VERTEX; ++b) {
+			float weight = weights[b][i];
+			if (weight == 0.0f) {
+				continue;
+			}
+			const float* m = palette + (((bones[i] >> (b * 8)) & 0xFF) * 16);
+			__m128 w = _mm_set1_ps(weight);
+
+			c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(m),		 w));
+			c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(m + 4),	 w));
+			c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(m + 8),	 w));
+			c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(m + 12), w));
+		}
+		__m128 clip = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(xs[i])), _mm_mul_ps(c1, _mm_set1_ps(ys[i]))),
+								 _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(zs[i])), c3));
+		float out[4];
+		_mm_storeu_ps(out, clip);
+
+		float invW = (out[3] > 0.0f) ? 1.0f / out[3] : 0.0f;
+
+		outX[i]		= out[0] * invW;
+		outY[i]		= out[1] * invW;
+		outZ[i]		= out[2] * invW;
+		outInvW[i]	= invW;
+	}
+}
+
+//Vertices all have w = 1, so the last column is just added on
+static inline __m128 TransformRow4(__m128 x, __m128 y, __m128 z, const float* m, int row) {
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m[row])), _mm_mul_ps(y, _mm_set1_ps(m[row + 4]))),
+					  _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(m[row + 8])), _mm_set1_ps(m[row + 12])));
+}
+
+//Transforms 4 points by m (which includes the viewport transform), returning a visibility bit per point
+static int TransformPoints4(const float* xs, const float* ys, const float* zs, const float* m, const PointLimits &l,
+	float* outX, float* outY, float* outDepth) {
+	__m128 x = _mm_load_ps(xs);
+	__m128 y = _mm_load_ps(ys);
+	__m128 z = _mm_load_ps(zs);
+
+	__m128 cx = TransformRow4(x, y, z, m, 0);
+	__m128 cy = TransformRow4(x, y, z, m, 1);
+	__m128 cz = TransformRow4(x, y, z, m, 2);
+	__m128 cw = TransformRow4(x, y, z, m, 3);
+
+	__m128 recip = _mm_div_ps(_mm_set1_ps(1.0f), cw);
+
+	__m128 sx = _mm_mul_ps(cx, recip);
+	__m128 sy = _mm_mul_ps(cy, recip);
+	__m128 sz = _mm_mul_ps(cz, recip);
+
+	__m128 inside = _mm_cmpgt_ps(cw, _mm_setzero_ps());
+	inside = _mm_and_ps(inside, _mm_cmpge_ps(sx, _mm_set1_ps(l.minX)));
+	inside = _mm_and_ps(inside, _mm_cmplt_ps(sx, _mm_set1_ps(l.maxX)));
+	inside = _mm_and_ps(inside, _mm_cmpge_ps(sy, _mm_set1_ps(l.minY)));
+	inside = _mm_and_ps(inside, _mm_cmplt_ps(sy, _mm_set1_ps(l.maxY)));
+	inside = _mm_and_ps(inside, _mm_cmpge_ps(sz, _mm_setzero_ps()));
+	inside = _mm_and_ps(inside, _mm_cmple_ps(sz, _mm_set1_ps(l.maxDepth)));
+
+	_mm_storeu_ps(outX, sx);
+	_mm_storeu_ps(outY, sy);
+	_mm_storeu_ps(outDepth, sz);
+
+	return _mm_movemask_ps(inside);
+}
+
+//SSE2 can only do half a batch at once
+static int TransformPointsSSE2(const float* xs, const float* ys, const float* zs, const float* m,
+	const PointLimits &l, PointBatch &out) {
+	int low  = TransformPoints4(xs,		ys,		zs,		m, l, out.x,	 out.y,		out.depth);
+	int high = TransformPoints4(xs + 4, ys + 4, zs + 4, m, l, out.x + 4, out.y + 4, out.depth + 4);
+
+	return low | (high << 4);
+}
+
+//A Colour is 4 bytes, so the 4 texels fit in a single register - we widen
+//them out to floats, weight all of them at once, and sum
+static __m128 BilinearFilterSSE2(const unsigned int texels[4], float xAmount, float yAmount) {
+	__m128i quad = _mm_loadu_si128((const __m128i*)texels);
+
+	__m128i zero	= _mm_setzero_si128();
+	__m128i top		= _mm_unpacklo_epi8(quad, zero);	//First 2 texels, as shorts
+	__m128i bottom	= _mm_unpackhi_epi8(quad, zero);	//Last 2 texels, as shorts
+
+	__m128 tl = _mm_cvtepi32_ps(_mm_unpacklo_epi16(top, zero));
+	__m128 tr = _mm_cvtepi32_ps(_mm_unpackhi_epi16(top, zero));
+	__m128 bl = _mm_cvtepi32_ps(_mm_unpacklo_epi16(bottom, zero));
+	__m128 br = _mm_cvtepi32_ps(_mm_unpackhi_epi16(bottom, zero));
+
+	__m128 result = _mm_mul_ps(tl, _mm_set1_ps((1.0f - xAmount) * (1.0f - yAmount)));
+	result = _mm_add_ps(result, _mm_mul_ps(tr, _mm_set1_ps(xAmount * (1.0f - yAmount))));
+	result = _mm_add_ps(result, _mm_mul_ps(bl, _mm_set1_ps((1.0f - xAmount) * yAmount)));
+	result = _mm_add_ps(result, _mm_mul_ps(br, _mm_set1_ps(xAmount * yAmount)));
+
+	return result;
+}
+
+//Streaming stores skip the cache - we're never going to read the frame back
+static void PresentBufferSSE2(unsigned int* dst, const unsigned int* src, uint count) {
+	uint i = 0;
+	for (; i < count && ((size_t)(dst + i) & 15); ++i) {
+		dst[i] = src[i];
+	}
+	for (; i + 4 <= count; i += 4) {
+		_mm_stream_si128((__m128i*)(dst + i), _mm_loadu_si128((const __m128i*)(src + i)));
+	}
+	for (; i < count; ++i) {
+		dst[i] = src[i];
+	}
+	_mm_sfence();
+}
+
+bool SIMDKernels::SetupSSE2(SIMDKernelTable &t) {
+	t.clearBuffers		= ClearBuffersSSE2;
+	t.triangleSpan		= TriangleSpanSSE2;
+	t.occluderRow		= OccluderRowSSE2;
+	t.occluderTest		= OccluderTestSSE2;
+	t.depthSpan			= DepthSpanSSE2;
+	t.transformVertices = TransformVerticesSSE2;
+	t.skinVertices		= SkinVerticesSSE2;
+	t.transformPoints	= TransformPointsSSE2;
+	t.bilinearFilter	= BilinearFilterSSE2;
+	t.presentBuffer		= PresentBufferSSE2;
+	return true;
+}
@@ -0,0 +1,27 @@
+/*
+SSE4.1 doesn't do much for us, apart from being able to widen bytes straight
+out to ints - which saves half the unpacking when filtering.
+*/
+#include "SIMDKernels.h"
+#include <smmintrin.h>
+
+static __m128 BilinearFilterSSE41(const unsigned int texels[4], float xAmount, float yAmount) {
+	__m128i quad = _mm_loadu_si128((const __m128i*)texels);
+
+	__m128 tl = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(quad));
+	__m128 tr = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(quad, 4)));
+	__m128 bl = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(quad, 8)));
+	__m128 br = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(quad, 12)));
+
+	__m128 result = _mm_mul_ps(tl, _mm_set1_ps((1.0f - xAmount) * (1.0f - yAmount)));
+	result = _mm_add_ps(result, _mm_mul_ps(tr, _mm_set1_ps(xAmount * (1.0f - yAmount))));
+	result = _mm_add_ps(result, _mm_mul_ps(bl, _mm_set1_ps((1.0f - xAmount) * yAmount)));
+	result = _mm_add_ps(result, _mm_mul_ps(br, _mm_set1_ps(xAmount * yAmount)));
+
+	return result;
+}
+
+bool SIMDKernels::SetupSSE41(SIMDKernelTable &t) {
+	t.bilinearFilter = BilinearFilterSSE41;
+	return true;
+}
@@ -0,0 +1,135 @@
+#include "SceneNode.h"
+#include <algorithm>
+
+SceneNode::SceneNode(RenderObject* object)	{
+	this->object	= object;
+	parent			= NULL;
+	worldDirty		= true;
+	subtreeDirty	= true;
+}
+
+SceneNode::~SceneNode(void)	{
+	for (vector<SceneNode*>::iterator i = children.begin(); i != children.end(); ++i) {
+		delete *i;
+	}
+}
+
+void SceneNode::AddChild(SceneNode* child) {
+	if (child->parent) {
+		child->parent->RemoveChild(child);
+	}
+	children.push_back(child);
+	child->parent = this;
+
+	//It's got a whole new set of parents to be relative to
+	child->worldDirty = false;
+	child->MarkWorldDirty();
+}
+
+void SceneNode::RemoveChild(SceneNode* child) {
+	vector<SceneNode*>::iterator i = std::find(children.begin(), children.end(), child);
+	if (i == children.end()) {
+		return;
+	}
+	children.erase(i);
+	child->parent = NULL;
+
+	child->worldDirty = false;
+	child->MarkWorldDirty();
+}
+
+void SceneNode::SetTransform(const Matrix4 &m) {
+	transform = m;
+	MarkWorldDirty();
+}
+
+void SceneNode::SetRenderObject(RenderObject* o) {
+	object = o;
+	//It'll want its modelMatrix setting, even if nothing's moved
+	worldDirty = false;
+	MarkWorldDirty();
+}
+
+/*
+Everything below a node moves with it, so they're all out of date too. If a
+node's already out of date, so is everything below it, and we can stop there -
+so moving the same node lots of times before the next Update is still cheap.
+*/
+void SceneNode::MarkWorldDirty() {
+	if (worldDirty) {
+		return;
+	}
+	worldDirty = true;
+	MarkSubtreeDirty();
+
+	for (vector<SceneNode*>::iterator i = children.begin(); i != children.end(); ++i) {
+		(*i)->MarkWorldDirty();
+	}
+}
+
+/*
+Leaves a trail up to the root, so Update can find its way back down. The walk
+starts at the parent - a node that's just been added somewhere new can already
+be dirty itself, without any of its new parents knowing about it.
+*/
+void SceneNode::MarkSubtreeDirty() {
+	subtreeDirty = true;
+	for (SceneNode* n = parent; n && !n->subtreeDirty; n = n->parent) {
+		n->subtreeDirty = true;
+	}
+}
+
+const Matrix4& SceneNode::GetWorldTransform() {
+	if (worldDirty) {
+		worldTransform	= parent ? parent->GetWorldTransform() * transform : transform;
+		worldDirty		= false;
+
+		if (object) {
+			object->modelMatrix = worldTransform;
+		}
+	}
+	return worldTransform;
+}
+
+/*
+Goes down the tree a level at a time, rather than recursing. Once a level's
+done, every parent of the next level is up to date, so the next level's world
+transforms are just one SSE Matrix4 product each, in one tight loop - there's
+no walking back up the tree to check on parents, and no call per node.
+*/
+void SceneNode::Update() {
+	if (!subtreeDirty) {
+		return;
+	}
+	GetWorldTransform();	//Along with any of our parents that need it
+
+	vector<SceneNode*> level(1, this);
+	vector<SceneNode*> next;
+
+	while (!level.empty()) {
+		next.clear();
+		for (size_t i = 0; i < level.size(); ++i) {
+			SceneNode* n = level[i];
+			n->subtreeDirty = false;
+
+			for (vector<SceneNode*>::iterator c = n->children.begin(); c != n->children.end(); ++c) {
+				if ((*c)->subtreeDirty) {
+					next.push_back(*c);
+				}
+			}
+		}
+		for (size_t i = 0; i < next.size(); ++i) {
+			SceneNode* n = next[i];
+			if (!n->worldDirty) {
+				continue;
+			}
+			n->worldTransform	= n->parent->worldTransform * n->transform;
+			n->worldDirty		= false;
+
+			if (n->object) {
+				n->object->modelMatrix = n->worldTransform;
+			}
+		}
+		level.swap(next);
+	}
+}
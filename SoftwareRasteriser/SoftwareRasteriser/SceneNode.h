@@ -0,0 +1,73 @@
+/******************************************************************************
+Class:SceneNode
+Implements:
+Description:A node in a tree of transforms, for models that are built out of
+parts - a robot's head and limbs hang off its body, so moving the body takes
+everything with it. Each node has a transform relative to its parent, and an
+optional RenderObject, whose modelMatrix is kept up to date with the node's
+world transform.
+
+World transforms are only worked out when they're needed. Changing a node's
+transform marks it and everything below it as out of date, and tells its
+parents that there's something to do further down - so Update only has to
+visit the parts of the tree that actually changed. Moving one arm of one
+robot out of hundreds doesn't touch any of the others.
+
+Deleting a node deletes all of its children, but not its RenderObject.
+
+-_-_-_-_-_-_-_,------,
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""
+
+*//////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Matrix4.h"
+#include "RenderObject.h"
+#include <vector>
+
+using std::vector;
+
+class SceneNode	{
+public:
+	SceneNode(RenderObject* object = NULL);
+	~SceneNode(void);
+
+	void	AddChild(SceneNode* child);
+	//Doesn't delete it - it's up to you what happens to it now
+	void	RemoveChild(SceneNode* child);
+
+	void			SetTransform(const Matrix4 &m);
+	const Matrix4&	GetTransform() const { return transform;}
+
+	//Worked out from the parents first, if anything's changed since last time
+	const Matrix4&	GetWorldTransform();
+
+	void			SetRenderObject(RenderObject* o);
+	RenderObject*	GetRenderObject() const { return object;}
+
+	SceneNode*		GetParent() const { return parent;}
+
+	vector<SceneNode*>::const_iterator GetChildIteratorStart()	{ return children.begin();}
+	vector<SceneNode*>::const_iterator GetChildIteratorEnd()	{ return children.end();}
+
+	//Brings the world transform of everything that's changed up to date, a
+	//whole level of the tree at a time
+	void	Update();
+
+protected:
+	void	MarkWorldDirty();
+	void	MarkSubtreeDirty();
+
+	SceneNode*			parent;
+	vector<SceneNode*>	children;
+
+	RenderObject*		object;
+
+	Matrix4				transform;		//Relative to the parent
+	Matrix4				worldTransform;
+
+	bool				worldDirty;		//worldTransform is out of date
+	bool				subtreeDirty;	//This node, or something below it, needs an Update
+};
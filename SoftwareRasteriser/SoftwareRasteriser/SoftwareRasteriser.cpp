@@ -1,427 +1,1648 @@
-#include "SoftwareRasteriser.h"
-#include <cmath>
-#include <math.h>
-/*
-While less 'neat' than just doing a 'new', like in the tutorials, it's usually
-possible to render a bit quicker to use direct pointers to the drawing area
-that the OS gives you. For a bit of a speedup, you can uncomment the define below
-to switch to using this method.
-
-For those of you new to the preprocessor, here's a quick explanation:
-
-Preprocessor definitions like #define allow parts of a file to be selectively enabled
-or disabled at compile time. This is useful for hiding parts of the codebase on a
-per-platform basis: if you have support for linux and windows in your codebase, obviously
-the linux platform won't have the windows platform headers available, so compilation will
-fail. So instead you can hide away all the platform specific stuff:
-
-#if PLATFORM_WINDOWS
- DoSomeWindowsStuff();
-#elif PLATFORM_LINUX
- DoSomeLinuxStuff();
- #else
- #error Unsupported Platform Specified!
- #endif
-
- As in our usage, it also allows you to selectively compile in some different functionality
- without any 'run time' cost - if it's not enabled by the preprocessor, it won't make it to
- the compiler, so no assembly will be generated.
-
-Also, I've implemented the Resize method for you, in a manner that'll behave itself
-no matter which method you use. I kinda forgot to do that, so there was a chance you'd
-get exceptions if you resized to a bigger screen area. Sorry about that.
-*/
-//#define USE_OS_BUFFERS
-
-SoftwareRasteriser::SoftwareRasteriser(uint width, uint height)	: Window(width, height){
-	currentDrawBuffer	= 0;
-
-#ifndef USE_OS_BUFFERS
-	//Hi! In the tutorials, it's mentioned that we need to form our front + back buffer like so:
-	for (int i = 0; i < 2; ++i) {
-		buffers[i] = new Colour[screenWidth * screenHeight];
-	}
-#else
-	//This works, but we can actually save a memcopy by rendering directly into the memory the 
-	//windowing system gives us, which I've added to the Window class as the 'bufferData' pointers
-	for (int i = 0; i < 2; ++i) {
-		buffers[i] = (Colour*)bufferData[i];
-	}
-#endif
-
-	depthBuffer		=	new unsigned short[screenWidth * screenHeight];
-
-	float zScale	= (pow(2.0f,16) - 1) * 0.5f;
-
-	Vector3 halfScreen = Vector3((screenWidth - 1) * 0.5f, (screenHeight - 1) * 0.5f, zScale);
-
-	portMatrix = Matrix4::Translation(halfScreen) * Matrix4::Scale(halfScreen);
-}
-
-SoftwareRasteriser::~SoftwareRasteriser(void)	{
-#ifndef USE_OS_BUFFERS
-	for(int i = 0; i < 2; ++i) {
-		delete[] buffers[i];
-	}
-#endif
-	delete[] depthBuffer;
-}
-
-void SoftwareRasteriser::Resize() {
-	Window::Resize(); //make sure our base class gets to do anything it needs to
-
-#ifndef USE_OS_BUFFERS
-	for (int i = 0; i < 2; ++i) {
-		delete[] buffers[i];
-		buffers[i] = new Colour[screenWidth * screenHeight];
-	}
-#else
-	for (int i = 0; i < 2; ++i) {
-		buffers[i] = (Colour*)bufferData[i];
-	}
-#endif
-
-	delete[] depthBuffer;
-	depthBuffer = new unsigned short[screenWidth * screenHeight];
-
-	float zScale = (pow(2.0f, 16) - 1) * 0.5f;
-
-	Vector3 halfScreen = Vector3((screenWidth - 1) * 0.5f, (screenHeight - 1) * 0.5f, zScale);
-
-	portMatrix = Matrix4::Translation(halfScreen) * Matrix4::Scale(halfScreen);
-}
-
-Colour*	SoftwareRasteriser::GetCurrentBuffer() {
-	return buffers[currentDrawBuffer];
-}
-
-void	SoftwareRasteriser::ClearBuffers() {
-	Colour* buffer = GetCurrentBuffer();
-
-	unsigned int clearVal = 0xFF000000;
-	unsigned int depthVal = ~0;
-
-	for(uint y = 0; y < screenHeight; ++y) {
-		for(uint x = 0; x < screenWidth; ++x) {
-			buffer[(y * screenWidth) + x].Reset();//c  = clearVal;
-			depthBuffer[(y * screenWidth) + x] = depthVal;
-		}
-	}
-}
-
-void	SoftwareRasteriser::SwapBuffers() {
-	PresentBuffer(buffers[currentDrawBuffer]);
-	currentDrawBuffer = !currentDrawBuffer;
-}
-
-void	SoftwareRasteriser::DrawObject(RenderObject*o) {
-	switch (o->GetMesh()->GetType()){
-		case PRIMITIVE_POINTS:{
-			RasterisePointsMesh(o);
-		}break;
-		case PRIMITIVE_LINES:{
-			RasteriseLinesMesh(o);
-		}break;
-		case PRIMITIVE_LINESTRIP:{
-			RasteriseLinestripMesh(o);
-		}break;
-		case PRIMITIVE_LINELOOP:{
-			RasteriseLineloopMesh(o);
-		}break;
-		case PRIMITIVE_TRIANGLES:{
-			RasteriseTriMesh(o);
-		}break;
-		case PRIMITIVE_TRIFAN:{
-			RasteriseTriFanMesh(o);
-		}break;
-	}
-}
-
-void	SoftwareRasteriser::RasterisePointsMesh(RenderObject*o) {
-
-	Matrix4 mvp = viewProjMatrix * o->GetModelMatrix();
-
-	for (uint i = 0; i < o->GetMesh()->numVertices; ++i)
-	{
-		Vector4 vertexPos = mvp * o->GetMesh()->vertices[i];
-		vertexPos.SelfDivisionByW();
-
-		Vector4 screenPos = portMatrix * vertexPos;
-		ShadePixel((uint)screenPos.x, (uint)screenPos.y, Colour::White);
-	}
-
-}
-
-void	SoftwareRasteriser::RasteriseLinesMesh(RenderObject*o) {
-
-	Matrix4 mvp = viewProjMatrix * o->GetModelMatrix();
-
-	for (uint i = 0; i < o->GetMesh()->numVertices; i += 2)
-	{
-		Vector4 v0 = mvp * o->GetMesh()->vertices[i];
-		Vector4 v1 = mvp * o->GetMesh()->vertices[i + 1];
-
-		Colour c0 = o->GetMesh()->colours[i];
-		Colour c1 = o->GetMesh()->colours[i + 1];
-
-		v0.SelfDivisionByW();
-		v1.SelfDivisionByW();
-
-		RasteriseLine(v0, v1, c0, c1);
-	}
-
-}
-
-void SoftwareRasteriser::RasteriseLinestripMesh(RenderObject*o){
-
-	Matrix4 mvp = viewProjMatrix * o->GetModelMatrix();
-
-	for (uint i = 0; i < o->GetMesh()->numVertices; ++i)
-	{
-		Vector4 v0 = mvp * o->GetMesh()->vertices[i];
-		Vector4 v1 = mvp * o->GetMesh()->vertices[i + 1];
-
-		v0.SelfDivisionByW();
-		v1.SelfDivisionByW();
-
-		RasteriseLine(v0, v1);
-	}
-
-}
-
-void SoftwareRasteriser::RasteriseLineloopMesh(RenderObject*o){
-
-	Matrix4 mvp = viewProjMatrix * o->GetModelMatrix();
-	uint max = o->GetMesh()->numVertices;
-
-	for (uint i = 0; i < max; ++i)
-	{
-		if (i == max - 1)
-		{
-			Vector4 v0 = mvp * o->GetMesh()->vertices[i];
-			Vector4 v1 = mvp * o->GetMesh()->vertices[0];
-
-			v0.SelfDivisionByW();
-			v1.SelfDivisionByW();
-
-			RasteriseLine(v0, v1);
-		}
-		else
-		{
-			Vector4 v0 = mvp * o->GetMesh()->vertices[i];
-			Vector4 v1 = mvp * o->GetMesh()->vertices[i + 1];
-
-			v0.SelfDivisionByW();
-			v1.SelfDivisionByW();
-
-			RasteriseLine(v0, v1);
-		}
-	}
-
-}
-
-void SoftwareRasteriser::RasteriseLine(	const Vector4 &vertA, const Vector4 &vertB,
-	const Colour &colA, const Colour &colB,
-										const Vector2 &texA, const Vector2 &texB){
-
-	// Transform our NDC coordinates to screen coordinates
-
-	Vector4 v0 = portMatrix * vertA;
-	Vector4 v1 = portMatrix * vertB;
-	Vector4 dir = v1 - v0; //What direction is the line going?
-
-	int xDir = (dir.x < 0.0f) ? -1 : 1; //Left or right?
-	int yDir = (dir.y < 0.0f) ? -1 : 1; //Up or down?
-
-	int x = (int)v0.x;
-	int y = (int)v0.y;
-
-	int* target = NULL; //Increment on error overflow, x or y?
-	int* scan = NULL; //Increment every iteration, x or y?
-	int scanVal = 0;
-	int targetVal = 0;
-
-	float slope = 0.0f;
-
-	int range = 0; //Bound our loop by this value;
-
-	// If we are steep, we have to scan over the y axis
-	if (abs(dir.y) > abs(dir.x))
-	{
-		slope = (dir.x / dir.y); // Error on x
-		range = (int)abs(dir.y); // Iterate over y
-
-		target = &x;
-		scan = &y;
-		scanVal = yDir;
-		targetVal = xDir;
-	}
-	else
-	{
-		slope = (dir.y / dir.x); // Error on y
-		range = (int)abs(dir.x); // Iterate over x
-
-		target = &y;
-		scan = &x;
-		scanVal = xDir;
-		targetVal = yDir;
-	}
-
-	float absSlope = abs(slope);
-	float error = 0.0f;
-	
-	float reciprocalRange = 1.0f / range;
-
-	for (int i = 0; i < range; ++i)
-	{
-		float t = i*reciprocalRange;
-		Colour currentCol = colB * t + colA * (1.0f - t);
-
-		ShadePixel(x, y, currentCol);
-
-		error += absSlope;
-
-		if (error > 0.5f)
-		{
-			error -= 1.0f;
-			(*target) += targetVal;
-		}
-		(*scan) += scanVal;
-	}
-}
-
-BoundingBox SoftwareRasteriser::CalculateBoxForTri(const Vector4 &a, const Vector4 &b, const Vector4 &c)
-{
-	BoundingBox box;
-
-	box.topLeft.x = a.x; // Start with the first vertex value
-	box.topLeft.x = min(box.topLeft.x, b.x); // Swap with 2 if less
-	box.topLeft.x = min(box.topLeft.x, c.x); // Swap with 3 if less
-	box.topLeft.x = max(box.topLeft.x, 0.0f); // Screen Bound.
-
-	box.topLeft.y = a.y; // Start with the first vertex value
-	box.topLeft.y = min(box.topLeft.y, b.y); // Swap with 2 if less
-	box.topLeft.y = min(box.topLeft.y, c.y); // Swap with 3 if less
-	box.topLeft.y = max(box.topLeft.y, 0.0f); // Screen Bound.
-
-	box.bottomRight.x = a.x; // Start with the first vertex value
-	box.bottomRight.x = max(box.bottomRight.x, b.x); // Swap with 2 if more
-	box.bottomRight.x = max(box.bottomRight.x, c.x); // Swap with 3 if more
-	box.bottomRight.x = min(box.bottomRight.x, screenWidth); // Screen Bound.
-
-	box.bottomRight.y = a.y; // Start with the first vertex value
-	box.bottomRight.y = max(box.bottomRight.y, b.y); // Swap with 2 if more
-	box.bottomRight.y = max(box.bottomRight.y, c.y); // Swap with 3 if more
-	box.bottomRight.y = min(box.bottomRight.y, screenHeight); // Screen Bound.
-
-	return box;
-}
-
-float SoftwareRasteriser::ScreenAreaOfTri(const Vector4 &a, const Vector4 &b, const Vector4 &c)
-{
-	float area = ((a.x*b.y) + (b.x*c.y) + (c.x*a.y)) -
-			((b.x*a.y) + (c.x*b.y) + (a.x*c.y));
-	return area * 0.5f;
-}
-
-void	SoftwareRasteriser::RasteriseTriMesh(RenderObject*o) {
-	Matrix4 mvp = viewProjMatrix * o->GetModelMatrix();
-
-	for (uint i = 0; i < o->GetMesh()->numVertices; i += 3)
-	{
-		Vector4 v0 = mvp * o->GetMesh()->vertices[i];
-		Vector4 v1 = mvp * o->GetMesh()->vertices[i + 1];
-		Vector4 v2 = mvp * o->GetMesh()->vertices[i + 2];
-
-		v0.SelfDivisionByW();
-		v1.SelfDivisionByW();
-		v2.SelfDivisionByW();
-
-		RasteriseTri(v0, v1, v2,
-			o->GetMesh()->colours[i],
-			o->GetMesh()->colours[i + 1],
-			o->GetMesh()->colours[i + 2]);
-	}
-}
-
-void SoftwareRasteriser::RasteriseTri(const Vector4 &triA, const Vector4 &triB, const Vector4 &triC,
-	const Colour &colA, const Colour &colB, const Colour &colC,
-	const Vector3 &texA, const Vector3 &texB, const Vector3 &texC)
-{
-	//Incoming triangles are in NDC space
-	Vector4 v0 = portMatrix * triA;
-	Vector4 v1 = portMatrix * triB;
-	Vector4 v2 = portMatrix * triC;
-
-	BoundingBox b = CalculateBoxForTri(v0, v1, v2);
-
-	float triArea = ScreenAreaOfTri(v0, v1, v2);
-	float areaRecip = 1.0f / triArea;
-
-	float subTriArea[3];
-	Vector4 screenPos(0, 0, 0, 1);
-
-	for (float y = b.topLeft.y; y < b.bottomRight.y; ++y)
-	{
-		for (float x = b.topLeft.x; x < b.bottomRight.x; ++x)
-		{
-			screenPos.x = x; // Create vertex 'p'
-			screenPos.y = y; // Create vertex 'p'
-
-			subTriArea[0] = abs(ScreenAreaOfTri(v0, screenPos, v1));
-			subTriArea[1] = abs(ScreenAreaOfTri(v1, screenPos, v2));
-			subTriArea[2] = abs(ScreenAreaOfTri(v2, screenPos, v0));
-
-			float triSum = subTriArea[0] + subTriArea[1] + subTriArea[2];
-
-			if (triSum > (triArea + 0.01f))
-			{
-				continue; // Current Pixel is NOT IN this triangle
-			}
-			if (triSum < 1.0f)
-			{
-				continue; // Tiny triangle we don't care about...
-			}
-			float alpha = subTriArea[1] * areaRecip;
-			float beta = subTriArea[2] * areaRecip;
-			float gamma = subTriArea[0] * areaRecip;
-
-			float zVal = (v0.z * alpha) +
-				(v1.z * beta) +
-				(v2.z * gamma);
-
-			if (!DepthFunc((int)x, (int)y, zVal)){
-				continue;
-			}
-
-			Colour subColour = ((colA * alpha) +
-				(colB * beta) +
-				(colC * gamma));
-
-			ShadePixel((uint)x, (uint)y, subColour);
-		}
-	}
-}
-
-void SoftwareRasteriser::RasteriseTriFanMesh(RenderObject*o){
-	Matrix4 mvp = viewProjMatrix * o->GetModelMatrix();
-
-	Vector4 v0 = mvp * o->GetMesh()->vertices[0];
-	v0.SelfDivisionByW();
-	for (uint i = 1; i < o->GetMesh()->numVertices; ++i)
-	{
-		
-		Vector4 v1 = mvp * o->GetMesh()->vertices[i];
-		Vector4 v2 = mvp * o->GetMesh()->vertices[i + 1];
-
-		
-		v1.SelfDivisionByW();
-		v2.SelfDivisionByW();
-
-		RasteriseTri(v0, v1, v2,
-			o->GetMesh()->colours[0],
-			o->GetMesh()->colours[i + 1],
-			o->GetMesh()->colours[i + 2]
-			);
-	}
+#include "SoftwareRasteriser.h"
+#include <cmath>
+#include <math.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include "SIMDKernels.h"
+#ifndef _WIN32
+#include <chrono>
+#endif
+/*
+While less 'neat' than just doing a 'new', like in the tutorials, it's usually
+possible to render a bit quicker to use direct pointers to the drawing area
+that the OS gives you. For a bit of a speedup, you can uncomment the define below
+to switch to using this method.
+
+For those of you new to the preprocessor, here's a quick explanation:
+
+Preprocessor definitions like #define allow parts of a file to be selectively enabled
+or disabled at compile time. This is useful for hiding parts of the codebase on a
+per-platform basis: if you have support for linux and windows in your codebase, obviously
+the linux platform won't have the windows platform headers available, so compilation will
+fail. So instead you can hide away all the platform specific stuff:
+
+#if PLATFORM_WINDOWS
+ DoSomeWindowsStuff();
+#elif PLATFORM_LINUX
+ DoSomeLinuxStuff();
+ #else
+ #error Unsupported Platform Specified!
+ #endif
+
+ As in our usage, it also allows you to selectively compile in some different functionality
+ without any 'run time' cost - if it's not enabled by the preprocessor, it won't make it to
+ the compiler, so no assembly will be generated.
+
+Also, I've implemented the Resize method for you, in a manner that'll behave itself
+no matter which method you use. I kinda forgot to do that, so there was a chance you'd
+get exceptions if you resized to a bigger screen area. Sorry about that.
+*/
+//#define USE_OS_BUFFERS
+
+SoftwareRasteriser::SoftwareRasteriser(uint width, uint height)	: Window(width, height){
+	currentDrawBuffer	= 0;
+	currentTexture		= NULL;
+	texSampleState		= SAMPLE_TRILINEAR;
+	depthTest			= true;
+	depthWrite			= true;
+	depthOnly			= false;
+	colourWrite			= true;
+	renderTarget		= NULL;
+	depthTarget			= NULL;
+	lineMode			= LINE_SOLID;
+	lineWidth			= 1.0f;
+	pointSize			= 1.0f;
+	shadingRate			= SHADING_1X1;
+	shadingTilesWide	= 0;
+	shadingTilesDirty	= false;
+	coarseTriangle		= 0;
+	incremental			= false;
+	lastFrameValid		= false;
+	chosenCloudNodes	= NULL;
+	meshLODBias			= 0.0f;
+	renderScale			= 1.0f;
+	minRenderScale		= 0.5f;
+	frameBudget			= 0.0f;
+	frameTime			= 0.0f;
+	lastFrameStart		= 0.0;
+
+	transformed			= NULL;
+	occludedCount		= 0;
+	queryActive			= false;
+	queryType			= QUERY_SAMPLES_PASSED;
+	querySamples		= 0;
+
+#ifndef USE_OS_BUFFERS
+	//Hi! In the tutorials, it's mentioned that we need to form our front + back buffer like so:
+	for (int i = 0; i < 2; ++i) {
+		buffers[i] = new Colour[screenWidth * screenHeight];
+	}
+#else
+	//This works, but we can actually save a memcopy by rendering directly into the memory the 
+	//windowing system gives us, which I've added to the Window class as the 'bufferData' pointers
+	for (int i = 0; i < 2; ++i) {
+		buffers[i] = (Colour*)bufferData[i];
+	}
+#endif
+
+	screenDepthBuffer	= new unsigned short[screenWidth * screenHeight];
+	depthBuffer			= screenDepthBuffer;
+
+	SetRenderScale(1.0f);
+}
+
+SoftwareRasteriser::~SoftwareRasteriser(void)	{
+#ifndef USE_OS_BUFFERS
+	for(int i = 0; i < 2; ++i) {
+		delete[] buffers[i];
+	}
+#endif
+	delete[] screenDepthBuffer;
+}
+
+void SoftwareRasteriser::Resize() {
+	Window::Resize(); //make sure our base class gets to do anything it needs to
+
+#ifndef USE_OS_BUFFERS
+	for (int i = 0; i < 2; ++i) {
+		delete[] buffers[i];
+		buffers[i] = new Colour[screenWidth * screenHeight];
+	}
+#else
+	for (int i = 0; i < 2; ++i) {
+		buffers[i] = (Colour*)bufferData[i];
+	}
+#endif
+
+	delete[] screenDepthBuffer;
+	screenDepthBuffer = new unsigned short[screenWidth * screenHeight];
+
+	SetRenderScale(renderScale);
+}
+
+/*
+The buffers are always big enough for the whole window, but only the top left
+renderWidth * renderHeight of them is drawn into - packed together, so a row
+is renderWidth long. Everything that works out where a pixel goes uses those,
+rather than the window size, and portMatrix squashes the view down to fit.
+*/
+void SoftwareRasteriser::SetRenderScale(float scale) {
+	renderScale		= clamp(scale, MIN_RENDER_SCALE, 1.0f);
+	lastFrameValid	= false;
+
+	UseTargets();
+}
+
+void SoftwareRasteriser::SetViewport(uint width, uint height) {
+	renderWidth		= width;
+	renderHeight	= height;
+
+	float zScale = (pow(2.0f, 16) - 1) * 0.5f;
+
+	Vector3 halfScreen = Vector3((renderWidth - 1) * 0.5f, (renderHeight - 1) * 0.5f, zScale);
+
+	portMatrix = Matrix4::Translation(halfScreen) * Matrix4::Scale(halfScreen);
+
+	CoarseSample empty = { Colour(), 0, 0 };
+	coarseSamples.assign(renderWidth, empty);
+	shadingTilesDirty = true;
+
+	PixelRect all = { 0, 0, (int)renderWidth, (int)renderHeight };
+	scissor = all;
+}
+
+void SoftwareRasteriser::SetRenderTarget(RenderTarget* t) {
+	renderTarget	= t;
+	depthTarget		= t ? t->depth : NULL;
+	UseTargets();
+}
+
+void SoftwareRasteriser::SetDepthTarget(DepthTarget* t) {
+	renderTarget	= NULL;
+	depthTarget		= t;
+	UseTargets();
+}
+
+//A new render scale doesn't do anything to targets - it's picked up when we
+//go back to drawing on the screen
+void SoftwareRasteriser::UseTargets() {
+	SetDepthOnly(depthOnly);
+
+	if (depthTarget) {
+		depthBuffer = depthTarget->depth;
+		SetViewport(depthTarget->width, depthTarget->height);
+	}
+	else {
+		depthBuffer = screenDepthBuffer;
+		SetViewport(max(1u, (uint)(screenWidth  * renderScale + 0.5f)),
+					max(1u, (uint)(screenHeight * renderScale + 0.5f)));
+	}
+}
+
+void SoftwareRasteriser::SetFrameTimeBudget(float milliseconds, float minScale) {
+	frameBudget		= milliseconds;
+	minRenderScale	= clamp(minScale, MIN_RENDER_SCALE, 1.0f);
+
+	if (frameBudget <= 0.0f) {
+		SetRenderScale(1.0f);
+	}
+}
+
+//VS2013's std::chrono clocks only tick every millisecond or so, which is
+//far too coarse to time frames with
+static double MillisecondsNow() {
+#ifdef _WIN32
+	LARGE_INTEGER now, frequency;
+	QueryPerformanceCounter(&now);
+	QueryPerformanceFrequency(&frequency);
+	return (now.QuadPart * 1000.0) / frequency.QuadPart;
+#else
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/*
+Called once a frame. Nearly all of our time goes on filling pixels, so the
+time taken goes up with the area - to get the frame time to budget / frameTime
+of what it is now, we need sqrt of that on each side. We only go part of the
+way there each frame, so a single slow frame doesn't make everything jump.
+*/
+void SoftwareRasteriser::UpdateRenderScale() {
+	double now = MillisecondsNow();
+	if (lastFrameStart > 0.0) {
+		float taken = (float)(now - lastFrameStart);
+		frameTime = (frameTime > 0.0f) ? frameTime + (taken - frameTime) * 0.25f : taken;
+	}
+	lastFrameStart = now;
+
+	if (frameBudget <= 0.0f || frameTime <= 0.0f) {
+		return;
+	}
+	float wanted	= renderScale * sqrt(frameBudget / frameTime);
+	float newScale	= clamp(renderScale + (wanted - renderScale) * 0.5f, minRenderScale, 1.0f);
+
+	//Not worth resizing for less than a pixel
+	if (fabs(newScale - renderScale) * screenWidth >= 1.0f) {
+		SetRenderScale(newScale);
+	}
+}
+
+/*
+Bilinear stretch from the render area of src up to the whole of dest. Both
+colours are blended at once by splitting the channels into red + blue and
+green + alpha, which leaves 8 bits of room above each one for the weights.
+*/
+static inline unsigned int LerpTexel(unsigned int a, unsigned int b, unsigned int t) {
+	unsigned int rb = (((a & 0x00FF00FF) * (256 - t) + (b & 0x00FF00FF) * t) >> 8) & 0x00FF00FF;
+	unsigned int ga = (((a >> 8) & 0x00FF00FF) * (256 - t) + ((b >> 8) & 0x00FF00FF) * t) & 0xFF00FF00;
+	return rb | ga;
+}
+
+void SoftwareRasteriser::UpscaleBuffer(const Colour* src, Colour* dest) {
+	//Everything in 16.16 fixed point, sampling from the middle of each pixel
+	int xStep	= (int)(((long long)renderWidth  << 16) / screenWidth);
+	int yStep	= (int)(((long long)renderHeight << 16) / screenHeight);
+	int lastX	= (int)renderWidth  - 1;
+	int lastY	= (int)renderHeight - 1;
+
+	int sy = (yStep / 2) - 0x8000;
+	for (uint y = 0; y < screenHeight; ++y, sy += yStep) {
+		int y0 = max(sy, 0) >> 16;
+		int y1 = min(y0 + 1, lastY);
+		uint ty = (max(sy, 0) >> 8) & 0xFF;
+
+		const unsigned int* top		= &src[y0 * renderWidth].c;
+		const unsigned int* bottom	= &src[y1 * renderWidth].c;
+		unsigned int*		out		= &dest[y * screenWidth].c;
+
+		int sx = (xStep / 2) - 0x8000;
+		for (uint x = 0; x < screenWidth; ++x, sx += xStep) {
+			int x0 = max(sx, 0) >> 16;
+			int x1 = min(x0 + 1, lastX);
+			uint tx = (max(sx, 0) >> 8) & 0xFF;
+
+			out[x] = LerpTexel(LerpTexel(top[x0], top[x1], tx), LerpTexel(bottom[x0], bottom[x1], tx), ty);
+		}
+	}
+}
+
+void	SoftwareRasteriser::ClearBuffers() {
+	if (depthTarget && !renderTarget) {
+		depthTarget->Clear();
+		return;
+	}
+	if (!depthTarget) {
+		occlusion.Clear();
+		occludedCount = 0;
+
+		if (incremental) {
+			return;	//Only the parts that change get cleared, in SwapBuffers
+		}
+	}
+	Colour* buffer = GetCurrentBuffer();
+
+	unsigned int clearVal = 0xFF000000;
+	unsigned int depthVal = ~0;
+
+	SIMDKernels::Get().clearBuffers(&buffer->c, depthBuffer, renderWidth * renderHeight,
+		clearVal, (unsigned short)depthVal);
+}
+
+void	SoftwareRasteriser::SwapBuffers() {
+	bool partial = false;
+	if (incremental) {
+		partial = lastFrameValid;
+		DrawIncremental();
+	}
+
+	if (renderWidth != screenWidth || renderHeight != screenHeight) {
+		//The other buffer is about to be cleared for the next frame anyway,
+		//so it's free to stretch this one out into
+		Colour* full = buffers[!currentDrawBuffer];
+		UpscaleBuffer(buffers[currentDrawBuffer], full);
+		PresentBuffer(full);
+	}
+	else if (partial) {
+		//The rects are kept sorted top to bottom, so the rows that overlap
+		//can be sent in one go
+		uint i = 0;
+		while (i < dirtyRects.size()) {
+			int top		= dirtyRects[i].top;
+			int bottom	= dirtyRects[i].bottom;
+			for (++i; i < dirtyRects.size() && dirtyRects[i].top <= bottom; ++i) {
+				bottom = max(bottom, dirtyRects[i].bottom);
+			}
+			PresentRows(buffers[currentDrawBuffer], top, bottom - 1);
+		}
+	}
+	else {
+		PresentBuffer(buffers[currentDrawBuffer]);
+	}
+	//Incremental frames build on the last one, so they stay in the same buffer
+	if (!incremental) {
+		currentDrawBuffer = !currentDrawBuffer;
+	}
+	UpdateRenderScale();
+}
+
+void	SoftwareRasteriser::SetIncrementalRendering(bool enabled) {
+	incremental		= enabled;
+	lastFrameValid	= false;
+	drawQueue.clear();
+	lastDraws.clear();
+}
+
+void	SoftwareRasteriser::DrawObject(RenderObject*o) {
+	if (incremental && !depthTarget) {
+		//Any samples queries don't draw anything, and by the time the queue
+		//is drawn the query's long gone - so they're not queued at all
+		if (!(queryActive && queryType == QUERY_ANY_SAMPLES_PASSED)) {
+			drawQueue.push_back(QueueDraw(o));
+		}
+		return;
+	}
+	DrawObjectNow(o, viewProjMatrix * o->GetModelMatrix());
+}
+
+void	SoftwareRasteriser::DrawNode(SceneNode*n) {
+	//Update already walks the whole subtree, so once is enough
+	n->Update();
+	DrawSubtree(n);
+}
+
+void	SoftwareRasteriser::DrawSubtree(SceneNode*n) {
+	if (n->GetRenderObject()) {
+		DrawObject(n->GetRenderObject());
+	}
+	for (vector<SceneNode*>::const_iterator i = n->GetChildIteratorStart(); i != n->GetChildIteratorEnd(); ++i) {
+		DrawSubtree(*i);
+	}
+}
+
+void	SoftwareRasteriser::DrawOccluder(RenderObject*o) {
+	//The occlusion buffer's for the screen's view, and a target's view could
+	//be from anywhere - a shadow map's light, say
+	if (depthTarget) {
+		return;
+	}
+	Mesh* m = o->occluder;
+	if (!m && !o->IsSkinned()) {
+		m = o->GetMesh();
+	}
+	if (m) {
+		occlusion.DrawOccluder(m, viewProjMatrix * o->GetModelMatrix());
+	}
+}
+
+void	SoftwareRasteriser::BeginQuery(QueryType type) {
+	queryActive		= true;
+	queryType		= type;
+	querySamples	= 0;
+}
+
+uint	SoftwareRasteriser::EndQuery() {
+	queryActive = false;
+
+	if (incremental && !depthTarget) {
+		return QUERY_RESULT_UNAVAILABLE;	//Nothing's been drawn yet
+	}
+	if (queryType == QUERY_ANY_SAMPLES_PASSED) {
+		return querySamples > 0 ? 1 : 0;
+	}
+	return querySamples;
+}
+
+void	SoftwareRasteriser::DrawObjectNow(RenderObject*o, const Matrix4 &mvp) {
+	if (QueryAnswered()) {
+		return;
+	}
+	if (!o->cloud && !depthTarget && !occlusion.IsEmpty()) {
+		Vector3 boxMin, boxMax;
+		o->GetModelBounds(boxMin, boxMax);
+
+		if (occlusion.BoxHidden(mvp, boxMin, boxMax)) {
+			++occludedCount;
+			return;
+		}
+	}
+	currentTexture	= o->GetTexure();
+	lineMode		= o->lineMode;
+	lineWidth		= o->lineWidth;
+	pointSize		= o->pointSize;
+	shadingRate		= o->shadingRate;
+
+	mvpMatrix		= mvp;
+	screenMatrix	= portMatrix * mvpMatrix;
+
+	if (o->cloud) {
+		RasterisePointCloud(o);
+		return;
+	}
+
+	switch (o->GetMesh()->GetType()){
+		case PRIMITIVE_POINTS:{
+			RasterisePointsMesh(o);
+		}break;
+		case PRIMITIVE_LINES:{
+			RasteriseLinesMesh(o);
+		}break;
+		case PRIMITIVE_LINESTRIP:{
+			RasteriseLinestripMesh(o);
+		}break;
+		case PRIMITIVE_LINELOOP:{
+			RasteriseLineloopMesh(o);
+		}break;
+		case PRIMITIVE_TRIANGLES:{
+			RasteriseTriMesh(o);
+		}break;
+		case PRIMITIVE_TRIFAN:{
+			RasteriseTriFanMesh(o);
+		}break;
+	}
+}
+
+QueuedDraw	SoftwareRasteriser::QueueDraw(RenderObject*o) {
+	QueuedDraw d;
+	d.object		= o;
+	d.changes		= o->GetChanges();
+	d.animated		= o->cloud || o->IsSkinned();
+	d.mvp			= viewProjMatrix * o->GetModelMatrix();
+	d.mesh			= o->GetMesh();
+	d.cloud			= o->cloud;
+	d.texture		= o->GetTexure();
+	d.lineMode		= o->lineMode;
+	d.lineWidth		= o->lineWidth;
+	d.pointSize		= o->pointSize;
+	d.shadingRate	= o->shadingRate;
+	d.depthTest		= depthTest;
+	d.depthWrite	= depthWrite;
+	d.depthOnly		= depthOnly;
+	d.sampleState	= texSampleState;
+	d.lodBias		= meshLODBias;
+
+	PixelRect none = { 0, 0, 0, 0 };
+	d.rect = none;
+
+	Vector3 boxMin, boxMax;
+	if (d.cloud) {
+		if (d.cloud->nodes.empty()) {
+			return d;
+		}
+		boxMin = d.cloud->nodes[0].boundsMin;
+		boxMax = d.cloud->nodes[0].boundsMax;
+	}
+	else {
+		o->GetModelBounds(boxMin, boxMax);
+	}
+	float pixelSize;
+	if (BoxOnScreen(d.mvp, boxMin, boxMax, pixelSize, d.rect)) {
+		//Wide lines, big points and antialiased edges can all spill over a bit
+		int spill = (int)ceil(max(d.lineWidth, d.pointSize) * 0.5f) + 1;
+		PixelRect grown = { d.rect.left - spill, d.rect.top - spill, d.rect.right + spill, d.rect.bottom + spill };
+		PixelRect all	= { 0, 0, (int)renderWidth, (int)renderHeight };
+		d.rect = grown.Intersection(all);
+	}
+	return d;
+}
+
+//Point clouds stream in more detail as it arrives, and skinned meshes move with
+//their bones, so they can change without anything here changing
+bool	SoftwareRasteriser::DrawChanged(const QueuedDraw &now, const QueuedDraw &last) const {
+	return	now.animated || now.object != last.object || now.changes != last.changes ||
+			memcmp(now.mvp.values, last.mvp.values, sizeof(now.mvp.values)) != 0 ||
+			now.mesh		!= last.mesh		|| now.cloud		!= last.cloud		||
+			now.texture		!= last.texture		|| now.lineMode		!= last.lineMode	||
+			now.lineWidth	!= last.lineWidth	|| now.pointSize	!= last.pointSize	||
+			now.shadingRate != last.shadingRate || now.depthTest	!= last.depthTest	||
+			now.depthWrite	!= last.depthWrite	|| now.depthOnly	!= last.depthOnly	||
+			now.sampleState != last.sampleState || now.lodBias		!= last.lodBias;
+}
+
+static void AddDirtyRect(vector<PixelRect> &rects, PixelRect r) {
+	if (r.Empty()) {
+		return;
+	}
+	//Anything it overlaps gets merged in, which might make it overlap
+	//something it didn't before - so go round again until it doesn't
+	for (uint i = 0; i < rects.size();) {
+		if (rects[i].Overlaps(r)) {
+			r = r.Union(rects[i]);
+			rects.erase(rects.begin() + i);
+			i = 0;
+		}
+		else {
+			++i;
+		}
+	}
+	rects.push_back(r);
+}
+
+static bool TopToBottom(const PixelRect &a, const PixelRect &b) {
+	return a.top < b.top;
+}
+
+/*
+Draws are matched up with last frame's by their position in the queue, so if
+something's added or taken out, everything after it counts as changed. That
+sounds wasteful, but the order matters - with the depth test off, things
+drawn later end up on top - so it's the only safe thing to do.
+
+Each dirty rect is cleared, then everything that touches it is drawn again
+with the scissor set to the rect, so nothing outside of it is touched.
+*/
+void	SoftwareRasteriser::DrawIncremental() {
+	PixelRect all = { 0, 0, (int)renderWidth, (int)renderHeight };
+
+	dirtyRects.clear();
+
+	if (!lastFrameValid) {
+		dirtyRects.push_back(all);
+	}
+	else {
+		uint common = min(drawQueue.size(), lastDraws.size());
+		for (uint i = 0; i < common; ++i) {
+			if (DrawChanged(drawQueue[i], lastDraws[i])) {
+				AddDirtyRect(dirtyRects, lastDraws[i].rect);
+				AddDirtyRect(dirtyRects, drawQueue[i].rect);
+			}
+		}
+		for (uint i = common; i < lastDraws.size(); ++i) {
+			AddDirtyRect(dirtyRects, lastDraws[i].rect);
+		}
+		for (uint i = common; i < drawQueue.size(); ++i) {
+			AddDirtyRect(dirtyRects, drawQueue[i].rect);
+		}
+		int area = 0;
+		for (uint i = 0; i < dirtyRects.size(); ++i) {
+			area += dirtyRects[i].Area();
+		}
+		if (dirtyRects.size() > MAX_DIRTY_RECTS || area * 4 > all.Area() * 3) {
+			dirtyRects.assign(1, all);
+		}
+	}
+	std::sort(dirtyRects.begin(), dirtyRects.end(), TopToBottom);
+
+	//Point clouds are walked (and ask for their missing nodes) once per frame,
+	//not once per dirty rect - each rect just draws what was picked here
+	queuedCloudNodes.resize(max(queuedCloudNodes.size(), drawQueue.size()));
+
+	for (uint i = 0; i < drawQueue.size(); ++i) {
+		const QueuedDraw &d = drawQueue[i];
+		if (!d.cloud) {
+			continue;
+		}
+		bool seen = false;
+		for (uint r = 0; r < dirtyRects.size() && !seen; ++r) {
+			seen = d.rect.Overlaps(dirtyRects[r]);
+		}
+		if (seen) {
+			mvpMatrix = d.mvp;
+			ChoosePointCloudNodes(d.object, queuedCloudNodes[i]);
+		}
+	}
+
+	//Drawing changes these, so put them back how the app left them afterwards
+	bool		oldDepthTest	= depthTest;
+	bool		oldDepthWrite	= depthWrite;
+	bool		oldDepthOnly	= depthOnly;
+	SampleState oldSampleState	= texSampleState;
+	float		oldLODBias		= meshLODBias;
+
+	for (uint r = 0; r < dirtyRects.size(); ++r) {
+		scissor = dirtyRects[r];
+		ClearRect(scissor);
+
+		for (uint i = 0; i < drawQueue.size(); ++i) {
+			const QueuedDraw &d = drawQueue[i];
+			if (!d.rect.Overlaps(scissor)) {
+				continue;
+			}
+			depthTest		= d.depthTest;
+			depthWrite		= d.depthWrite;
+			texSampleState	= d.sampleState;
+			meshLODBias		= d.lodBias;
+			SetDepthOnly(d.depthOnly);
+
+			chosenCloudNodes = d.cloud ? &queuedCloudNodes[i] : NULL;
+			DrawObjectNow(d.object, d.mvp);
+		}
+	}
+	chosenCloudNodes = NULL;
+	scissor			= all;
+	depthTest		= oldDepthTest;
+	depthWrite		= oldDepthWrite;
+	texSampleState	= oldSampleState;
+	meshLODBias		= oldLODBias;
+	SetDepthOnly(oldDepthOnly);
+
+	lastDraws.swap(drawQueue);
+	drawQueue.clear();
+	lastFrameValid = true;
+}
+
+void	SoftwareRasteriser::ClearRect(const PixelRect &r) {
+	Colour* buffer = GetCurrentBuffer();
+
+	unsigned int clearVal = 0xFF000000;
+	unsigned int depthVal = ~0;
+
+	const SIMDKernelTable &simd = SIMDKernels::Get();
+
+	for (int y = r.top; y < r.bottom; ++y) {
+		int index = (y * renderWidth) + r.left;
+		simd.clearBuffers(&buffer[index].c, &depthBuffer[index], r.right - r.left,
+			clearVal, (unsigned short)depthVal);
+	}
+}
+
+/*
+Points are transformed in batches - the mesh keeps each component in its own
+stream, so a single load picks up the same component of a whole batch of
+points, and the transform, divide and frustum cull are the same handful of
+instructions for all of them. Only the visible points have to go through the
+depth test one by one. The batch is done by whichever SIMDKernels the CPU
+can run.
+*/
+void	SoftwareRasteriser::RasterisePointsMesh(RenderObject*o) {
+	// Going straight from model space to the screen saves a transform per point
+	RasterisePoints(o->GetMesh(), screenMatrix);
+}
+
+void	SoftwareRasteriser::RasterisePoints(const Mesh* mesh, const Matrix4 &mvp) {
+	Colour* buffer = GetCurrentBuffer();
+
+	// Splats can be partly on screen even if their centre isn't
+	float edge = (pointSize > 1.0f) ? pointSize * 0.5f : 0.0f;
+
+	PointLimits limits;
+	limits.minX		= scissor.left	 - edge;
+	limits.maxX		= scissor.right	 + edge;
+	limits.minY		= scissor.top	 - edge;
+	limits.maxY		= scissor.bottom + edge;
+	limits.maxDepth = 65535.0f;	//Depth range after the viewport transform
+
+	PointBatch batch;
+
+	const SIMDKernelTable &simd = SIMDKernels::Get();
+
+	for (uint i = 0; i < mesh->numVertices && !QueryAnswered(); i += POINT_BATCH_SIZE)
+	{
+		int visible = simd.transformPoints(&mesh->positionX[i], &mesh->positionY[i], &mesh->positionZ[i],
+			mvp.values, limits, batch);
+
+		// The streams are padded out to a whole batch - ignore the padding!
+		uint count = mesh->numVertices - i;
+		if (count < POINT_BATCH_SIZE) {
+			visible &= (1 << count) - 1;
+		}
+
+		for (uint j = 0; visible; ++j, visible >>= 1)
+		{
+			if (!(visible & 1)) {
+				continue;
+			}
+			const Colour &c = mesh->GetColour(i + j);
+
+			if (pointSize > 1.0f) {
+				SplatPoint(batch.x[j], batch.y[j], batch.depth[j], c);
+				continue;
+			}
+			int index = ((int)batch.y[j] * renderWidth) + (int)batch.x[j];
+
+			if (DepthFunc(index, batch.depth[j])) {
+				buffer[index] = c;
+			}
+		}
+	}
+}
+
+/*
+Walks down the cloud's octree, picking every loaded node that's in view, and
+only carrying on into a node's children while it's still bigger on screen
+than the LOD threshold. Nodes we'd like to draw but haven't got yet are sent
+off to the loader - we don't go any further down those until they arrive.
+*/
+void	SoftwareRasteriser::ChoosePointCloudNodes(RenderObject*o, vector<int> &chosen) {
+	PointCloud* cloud = o->cloud;
+
+	chosen.clear();
+	cloud->CollectLoaded();
+
+	if (cloud->nodes.empty()) {
+		return;
+	}
+	vector<int>						toVisit(1, 0);	//Start at the root
+	vector<std::pair<float, int> >	wanted;
+
+	while (!toVisit.empty()) {
+		int index = toVisit.back();
+		toVisit.pop_back();
+
+		PointCloud::Node &n = cloud->nodes[index];
+
+		float pixelSize;
+		if (!BoxOnScreen(mvpMatrix, n.boundsMin, n.boundsMax, pixelSize)) {
+			continue;
+		}
+		if (!n.points) {
+			wanted.push_back(std::make_pair(pixelSize, index));
+			continue;
+		}
+		n.lastUsed = cloud->frame;
+		chosen.push_back(index);
+
+		cloud->stats.nodesDrawn++;
+		cloud->stats.pointsDrawn += n.points->GetNumVertices();
+
+		if (pixelSize > cloud->lodThreshold) {
+			for (int c = 0; c < 8; ++c) {
+				if (n.children[c] >= 0) {
+					toVisit.push_back(n.children[c]);
+				}
+			}
+		}
+	}
+	cloud->RequestNodes(wanted);
+}
+
+void	SoftwareRasteriser::RasterisePointCloud(RenderObject*o) {
+	const vector<int>* nodes = chosenCloudNodes;
+	if (!nodes) {
+		ChoosePointCloudNodes(o, cloudNodes);
+		nodes = &cloudNodes;
+	}
+	for (uint i = 0; i < nodes->size() && !QueryAnswered(); ++i) {
+		RasterisePoints(o->cloud->nodes[(*nodes)[i]].points, screenMatrix);
+	}
+}
+
+bool	SoftwareRasteriser::BoxOnScreen(const Matrix4 &mvp, const Vector3 &boxMin, const Vector3 &boxMax, float &pixelSize) {
+	PixelRect rect;
+	return BoxOnScreen(mvp, boxMin, boxMax, pixelSize, rect);
+}
+
+bool	SoftwareRasteriser::BoxOnScreen(const Matrix4 &mvp, const Vector3 &boxMin, const Vector3 &boxMax, float &pixelSize, PixelRect &rect) {
+	int		outside[6]	= { 0, 0, 0, 0, 0, 0 };
+	bool	behind		= false;
+
+	float	minX = FLT_MAX, maxX = -FLT_MAX;
+	float	minY = FLT_MAX, maxY = -FLT_MAX;
+
+	for (int i = 0; i < 8; ++i) {
+		Vector4 corner(	(i & 1) ? boxMax.x : boxMin.x,
+						(i & 2) ? boxMax.y : boxMin.y,
+						(i & 4) ? boxMax.z : boxMin.z, 1.0f);
+
+		Vector4 clip = mvp * corner;
+
+		outside[0] += (clip.x < -clip.w);
+		outside[1] += (clip.x >	clip.w);
+		outside[2] += (clip.y < -clip.w);
+		outside[3] += (clip.y >	clip.w);
+		outside[4] += (clip.z < -clip.w);
+		outside[5] += (clip.z >	clip.w);
+
+		if (clip.w <= 0.0f) {
+			behind = true;
+			continue;
+		}
+		float x = clip.x / clip.w;
+		float y = clip.y / clip.w;
+
+		minX = min(minX, x);
+		maxX = max(maxX, x);
+		minY = min(minY, y);
+		maxY = max(maxY, y);
+	}
+	// If every corner is outside of the same plane, the whole box is
+	for (int p = 0; p < 6; ++p) {
+		if (outside[p] == 8) {
+			return false;
+		}
+	}
+	if (behind) {
+		pixelSize = FLT_MAX;
+
+		PixelRect all = { 0, 0, (int)renderWidth, (int)renderHeight };
+		rect = all;
+	}
+	else {
+		pixelSize = max((maxX - minX) * 0.5f * renderWidth, (maxY - minY) * 0.5f * renderHeight);
+
+		//The same as portMatrix does. Anything off the edge is clamped first,
+		//as corners close to the camera plane can be a long way off it
+		float halfWidth		= (renderWidth  - 1) * 0.5f;
+		float halfHeight	= (renderHeight - 1) * 0.5f;
+
+		minX = clamp(minX, -1.0f, 1.0f);
+		maxX = clamp(maxX, -1.0f, 1.0f);
+		minY = clamp(minY, -1.0f, 1.0f);
+		maxY = clamp(maxY, -1.0f, 1.0f);
+
+		rect.left	= (int)floor((minX * halfWidth)  + halfWidth);
+		rect.top	= (int)floor((minY * halfHeight) + halfHeight);
+		rect.right	= (int)ceil ((maxX * halfWidth)  + halfWidth)  + 1;
+		rect.bottom = (int)ceil ((maxY * halfHeight) + halfHeight) + 1;
+	}
+	return true;
+}
+
+//Draws a pointSize square, all at the same depth, clipped to the screen
+void	SoftwareRasteriser::SplatPoint(float x, float y, float depth, const Colour &c) {
+	int size	= (int)(pointSize + 0.5f);
+
+	int left	= (int)floor(x - (pointSize * 0.5f) + 0.5f);
+	int top		= (int)floor(y - (pointSize * 0.5f) + 0.5f);
+
+	int xStart	= max(left, scissor.left);
+	int yStart	= max(top,	scissor.top);
+	int xEnd	= min(left + size, scissor.right);
+	int yEnd	= min(top  + size, scissor.bottom);
+
+	Colour* buffer = GetCurrentBuffer();
+
+	for (int py = yStart; py < yEnd; ++py) {
+		int index = (py * renderWidth) + xStart;
+
+		for (int px = xStart; px < xEnd; ++px, ++index) {
+			if (DepthFunc(index, depth)) {
+				buffer[index] = c;
+			}
+		}
+	}
+}
+
+void	SoftwareRasteriser::RasteriseLinesMesh(RenderObject*o) {
+
+	for (uint i = 0; i + 1 < o->GetMesh()->numVertices && !QueryAnswered(); i += 2)
+	{
+		Vector4 v0 = mvpMatrix * o->GetMesh()->GetPosition(i);
+		Vector4 v1 = mvpMatrix * o->GetMesh()->GetPosition(i + 1);
+
+		Colour c0 = o->GetMesh()->GetColour(i);
+		Colour c1 = o->GetMesh()->GetColour(i + 1);
+
+		RasteriseLine(v0, v1, c0, c1);
+	}
+
+}
+
+void SoftwareRasteriser::RasteriseLinestripMesh(RenderObject*o){
+
+	for (uint i = 0; i + 1 < o->GetMesh()->numVertices && !QueryAnswered(); ++i)
+	{
+		Vector4 v0 = mvpMatrix * o->GetMesh()->GetPosition(i);
+		Vector4 v1 = mvpMatrix * o->GetMesh()->GetPosition(i + 1);
+
+		RasteriseLine(v0, v1);
+	}
+
+}
+
+void SoftwareRasteriser::RasteriseLineloopMesh(RenderObject*o){
+
+	uint max = o->GetMesh()->numVertices;
+
+	for (uint i = 0; i < max && !QueryAnswered(); ++i)
+	{
+		Vector4 v0 = mvpMatrix * o->GetMesh()->GetPosition(i);
+		Vector4 v1 = mvpMatrix * o->GetMesh()->GetPosition((i + 1) % max);
+
+		RasteriseLine(v0, v1);
+	}
+
+}
+
+/*
+Liang-Barsky clipping - every edge of the viewport gives us a range of t
+(0 at the start of the line, 1 at the end) that's on the inside of it, and we
+just keep narrowing t0 and t1 down. If they cross, nothing's left!
+*/
+static bool ClipLineT(float p, float q, float &t0, float &t1) {
+	if (p == 0.0f) {
+		return q >= 0.0f; //Parallel to this edge - all in or all out
+	}
+	float t = q / p;
+	if (p < 0.0f) {
+		if (t > t1) {
+			return false;
+		}
+		t0 = max(t0, t);
+	}
+	else {
+		if (t < t0) {
+			return false;
+		}
+		t1 = min(t1, t);
+	}
+	return true;
+}
+
+bool SoftwareRasteriser::ClipLineToViewport(Vector4 &v0, Vector4 &v1, float &t0, float &t1) {
+	float xMin = (float)scissor.left;
+	float yMin = (float)scissor.top;
+	float xMax = (float)(scissor.right - 1);
+	float yMax = (float)(scissor.bottom - 1);
+
+	float dx = v1.x - v0.x;
+	float dy = v1.y - v0.y;
+
+	t0 = 0.0f;
+	t1 = 1.0f;
+
+	if (!ClipLineT(-dx, v0.x - xMin, t0, t1) ||
+		!ClipLineT( dx, xMax - v0.x, t0, t1) ||
+		!ClipLineT(-dy, v0.y - yMin, t0, t1) ||
+		!ClipLineT( dy, yMax - v0.y, t0, t1)) {
+		return false;
+	}
+	Vector4 dir = v1 - v0;
+
+	v1 = v0 + (dir * t1);
+	v0 = v0 + (dir * t0);
+
+	return true;
+}
+
+void SoftwareRasteriser::RasteriseLine(	const Vector4 &vertA, const Vector4 &vertB,
+	const Colour &colA, const Colour &colB,
+										const Vector2 &texA, const Vector2 &texB){
+
+	// Cut off anything in front of the near plane or past the far plane
+	// while we've still got w - the depth buffer can't hold it anyway
+	float n0 = 0.0f;
+	float n1 = 1.0f;
+
+	float nearA = vertA.z + vertA.w, nearB = vertB.z + vertB.w;
+	float farA	= vertA.w - vertA.z, farB  = vertB.w - vertB.z;
+
+	if (!ClipLineT(nearA - nearB, nearA, n0, n1) ||
+		!ClipLineT(farA  - farB,  farA,	 n0, n1)) {
+		return;
+	}
+	Vector4 dir = vertB - vertA;
+
+	Vector4 v0 = vertA + (dir * n0);
+	Vector4 v1 = vertA + (dir * n1);
+
+	v0.SelfDivisionByW();
+	v1.SelfDivisionByW();
+
+	// Transform our NDC coordinates to screen coordinates
+
+	v0 = portMatrix * v0;
+	v1 = portMatrix * v1;
+
+	Colour nearCol = Colour::Lerp(colA, colB, n0);
+	Colour farCol  = Colour::Lerp(colA, colB, n1);
+
+	// Wide lines are clipped a row at a time, as their edges can still
+	// be on screen when the line itself isn't
+	if (lineWidth > 1.0f) {
+		RasteriseWideLine(v0, v1, nearCol, farCol);
+		return;
+	}
+
+	// Clip once up front, so we never have to check a pixel is on screen
+	float t0, t1;
+	if (!ClipLineToViewport(v0, v1, t0, t1)) {
+		return;
+	}
+	Colour c0 = Colour::Lerp(nearCol, farCol, t0);
+	Colour c1 = Colour::Lerp(nearCol, farCol, t1);
+
+	if (lineMode == LINE_ANTIALIASED) {
+		RasteriseSmoothLine(v0, v1, c0, c1);
+	}
+	else {
+		RasteriseSolidLine(v0, v1, c0, c1);
+	}
+}
+
+void SoftwareRasteriser::RasteriseSolidLine(const Vector4 &v0, const Vector4 &v1, const Colour &c0, const Colour &c1) {
+	int x0 = (int)(v0.x + 0.5f);
+	int y0 = (int)(v0.y + 0.5f);
+	int x1 = (int)(v1.x + 0.5f);
+	int y1 = (int)(v1.y + 0.5f);
+
+	int dx = abs(x1 - x0);
+	int dy = abs(y1 - y0);
+
+	// Walk along whichever axis is longest, one pixel at a time, and step
+	// along the other one whenever the error term says we've gone far enough
+	int xStep = (x1 < x0) ? -1 : 1;
+	int yStep = (y1 < y0) ? -(int)renderWidth : (int)renderWidth;
+
+	int majorStep = (dx >= dy) ? xStep : yStep;
+	int minorStep = (dx >= dy) ? yStep : xStep;
+	int major	  = max(dx, dy);
+	int minor	  = min(dx, dy);
+
+	int error = (2 * minor) - major;
+
+	// Colour channels in 16.16 fixed point, so each pixel is just 4 adds
+	int divisor = max(major, 1);
+
+	// (multiplied rather than shifted, as the differences can be negative)
+	int r = c0.r * 65536, dr = ((c1.r - c0.r) * 65536) / divisor;
+	int g = c0.g * 65536, dg = ((c1.g - c0.g) * 65536) / divisor;
+	int b = c0.b * 65536, db = ((c1.b - c0.b) * 65536) / divisor;
+	int a = c0.a * 65536, da = ((c1.a - c0.a) * 65536) / divisor;
+
+	// Depth is linear in screen space, but doesn't fit in 16.16
+	float depth	 = v0.z;
+	float dDepth = (v1.z - v0.z) / divisor;
+
+	Colour* buffer = GetCurrentBuffer();
+	int index = (y0 * renderWidth) + x0;
+
+	for (int i = 0; i <= major; ++i)
+	{
+		if (DepthFunc(index, depth)) {
+			buffer[index].c =	((unsigned int)(a >> 16) << 24) | ((unsigned int)(r >> 16) << 16) |
+								((unsigned int)(g >> 16) << 8)  |  (unsigned int)(b >> 16);
+		}
+
+		if (error > 0) {
+			index += minorStep;
+			error -= 2 * major;
+		}
+		error += 2 * minor;
+		index += majorStep;
+
+		r += dr;
+		g += dg;
+		b += db;
+		a += da;
+
+		depth += dDepth;
+	}
+}
+
+/*
+Xiaolin Wu's line algorithm - we step along the major axis just like
+Bresenham, but the line's exact position on the minor axis is kept, and it
+is shared between the two pixels it falls between, by how close it is to each.
+Steep lines are drawn with their axes swapped, so we only handle one case.
+*/
+void SoftwareRasteriser::RasteriseSmoothLine(const Vector4 &v0, const Vector4 &v1, const Colour &c0, const Colour &c1) {
+	bool steep = fabs(v1.y - v0.y) > fabs(v1.x - v0.x);
+
+	float	ax = steep ? v0.y : v0.x;
+	float	ay = steep ? v0.x : v0.y;
+	float	bx = steep ? v1.y : v1.x;
+	float	by = steep ? v1.x : v1.y;
+	float	az = v0.z;
+	float	bz = v1.z;
+	Colour	ca = c0;
+	Colour	cb = c1;
+
+	if (ax > bx) {
+		std::swap(ax, bx);
+		std::swap(ay, by);
+		std::swap(az, bz);
+		std::swap(ca, cb);
+	}
+	int majorStart	= (int)(ax + 0.5f);
+	int majorEnd	= (int)(bx + 0.5f);
+	int minorMin	= steep ? scissor.left : scissor.top;
+	int minorMax	= steep ? scissor.right - 1 : scissor.bottom - 1;
+
+	int majorStride = steep ? renderWidth : 1;
+	int minorStride = steep ? 1 : renderWidth;
+
+	float gradient	= (bx > ax) ? (by - ay) / (bx - ax) : 0.0f;
+	float minor		= ay + (gradient * (majorStart - ax));
+
+	float divisor	= (float)max(majorEnd - majorStart, 1);
+	float t			= 0.0f;
+	float dt		= 1.0f / divisor;
+	float depth		= az;
+	float dDepth	= (bz - az) / divisor;
+
+	for (int major = majorStart; major <= majorEnd; ++major)
+	{
+		int		minorInt = (int)floor(minor);
+		float	frac	 = minor - minorInt;
+
+		Colour	c	  = Colour::Lerp(ca, cb, t);
+		int		index = (major * majorStride) + (minorInt * minorStride);
+
+		// The viewport clip keeps us on screen along the major axis,
+		// but the second pixel can still poke over the edge
+		if (minorInt >= minorMin && minorInt <= minorMax) {
+			BlendPixel(index, depth, c, 1.0f - frac);
+		}
+		if (minorInt + 1 >= minorMin && minorInt + 1 <= minorMax) {
+			BlendPixel(index + minorStride, depth, c, frac);
+		}
+		minor	+= gradient;
+		t		+= dt;
+		depth	+= dDepth;
+	}
+}
+
+/*
+Narrows [xMin, xMax] down to the x values on a row where start + (x * perX)
+is between lo and hi. Returns false if there aren't any.
+*/
+static bool SpanLimits(float start, float perX, float lo, float hi, float &xMin, float &xMax) {
+	if (fabs(perX) < 0.000001f) {
+		return start >= lo && start <= hi;	//Same for the whole row
+	}
+	float a = (lo - start) / perX;
+	float b = (hi - start) / perX;
+
+	if (a > b) {
+		std::swap(a, b);
+	}
+	xMin = max(xMin, a);
+	xMax = min(xMax, b);
+
+	return xMin <= xMax;
+}
+
+/*
+A wide line is a rectangle around the segment. For every row it touches we
+work out how far the start of the row is along and across the line - both
+of those change by a constant amount per pixel, so each row is a single span
+with its ends found directly, and walking along it is just two adds.
+Anti-aliased wide lines fade out over half a pixel either side of the edges.
+*/
+void SoftwareRasteriser::RasteriseWideLine(const Vector4 &v0, const Vector4 &v1, const Colour &c0, const Colour &c1) {
+	float dx = v1.x - v0.x;
+	float dy = v1.y - v0.y;
+
+	float length = sqrt((dx * dx) + (dy * dy));
+	if (length < 0.0001f) {
+		return;
+	}
+	// Unit vectors along and across the line
+	float alongX  = dx / length;
+	float alongY  = dy / length;
+	float acrossX = -alongY;
+	float acrossY = alongX;
+
+	bool  smooth	= (lineMode == LINE_ANTIALIASED);
+	float halfWidth = lineWidth * 0.5f;
+	float feather	= smooth ? 0.5f : 0.0f;
+	float extent	= halfWidth + feather;
+
+	int yStart = max(scissor.top,			(int)floor(min(v0.y, v1.y) - extent));
+	int yEnd   = min(scissor.bottom - 1,	(int)ceil (max(v0.y, v1.y) + extent));
+
+	Colour* buffer = GetCurrentBuffer();
+
+	for (int y = yStart; y <= yEnd; ++y)
+	{
+		float rowY		 = y - v0.y;
+		float alongRow	 = (-v0.x * alongX)  + (rowY * alongY);
+		float acrossRow  = (-v0.x * acrossX) + (rowY * acrossY);
+
+		float xMin = (float)scissor.left;
+		float xMax = (float)(scissor.right - 1);
+
+		if (!SpanLimits(alongRow,  alongX,  -feather, length + feather, xMin, xMax) ||
+			!SpanLimits(acrossRow, acrossX, -extent,  extent,			 xMin, xMax)) {
+			continue;
+		}
+		int xStart	= (int)ceil(xMin);
+		int xEnd	= (int)floor(xMax);
+
+		float along	 = alongRow  + (xStart * alongX);
+		float across = acrossRow + (xStart * acrossX);
+
+		int index = (y * renderWidth) + xStart;
+
+		for (int x = xStart; x <= xEnd; ++x, ++index)
+		{
+			float t		= min(max(along / length, 0.0f), 1.0f);
+			float depth = v0.z + ((v1.z - v0.z) * t);
+
+			if (smooth) {
+				float edge	= halfWidth + 0.5f - fabs(across);
+				float ends	= min(along + 0.5f, length + 0.5f - along);
+
+				BlendPixel(index, depth, Colour::Lerp(c0, c1, t), min(edge, ends));
+			}
+			else if (DepthFunc(index, depth)) {
+				buffer[index] = Colour::Lerp(c0, c1, t);
+			}
+			along  += alongX;
+			across += acrossX;
+		}
+	}
+}
+
+BoundingBox SoftwareRasteriser::CalculateBoxForTri(const Vector4 &a, const Vector4 &b, const Vector4 &c)
+{
+	BoundingBox box;
+
+	box.topLeft.x = a.x; // Start with the first vertex value
+	box.topLeft.x = min(box.topLeft.x, b.x); // Swap with 2 if less
+	box.topLeft.x = min(box.topLeft.x, c.x); // Swap with 3 if less
+	box.topLeft.x = max(box.topLeft.x, (float)scissor.left); // Screen Bound.
+
+	box.topLeft.y = a.y; // Start with the first vertex value
+	box.topLeft.y = min(box.topLeft.y, b.y); // Swap with 2 if less
+	box.topLeft.y = min(box.topLeft.y, c.y); // Swap with 3 if less
+	box.topLeft.y = max(box.topLeft.y, (float)scissor.top); // Screen Bound.
+
+	box.bottomRight.x = a.x; // Start with the first vertex value
+	box.bottomRight.x = max(box.bottomRight.x, b.x); // Swap with 2 if more
+	box.bottomRight.x = max(box.bottomRight.x, c.x); // Swap with 3 if more
+	box.bottomRight.x = min(box.bottomRight.x, (float)scissor.right); // Screen Bound.
+
+	box.bottomRight.y = a.y; // Start with the first vertex value
+	box.bottomRight.y = max(box.bottomRight.y, b.y); // Swap with 2 if more
+	box.bottomRight.y = max(box.bottomRight.y, c.y); // Swap with 3 if more
+	box.bottomRight.y = min(box.bottomRight.y, (float)scissor.bottom); // Screen Bound.
+
+	return box;
+}
+
+float SoftwareRasteriser::ScreenAreaOfTri(const Vector4 &a, const Vector4 &b, const Vector4 &c)
+{
+	float area = ((a.x*b.y) + (b.x*c.y) + (c.x*a.y)) -
+			((b.x*a.y) + (c.x*b.y) + (a.x*c.y));
+	return area * 0.5f;
+}
+
+void	SoftwareRasteriser::TransformVertices(RenderObject* o, const Mesh* m) {
+	TransformedVertices &t = o->GetTransformedVertices();
+	transformed = &t;
+
+	bool skinned = o->IsSkinned() && m == o->GetMesh();
+
+	//Nothing's moved since last time? Then they're still right
+	if (!skinned && t.valid && t.mesh == m && t.changes == o->GetChanges() &&
+		memcmp(t.matrix.values, screenMatrix.values, sizeof(screenMatrix.values)) == 0) {
+		return;
+	}
+	if (t.capacity < m->numVertices) {
+		Mesh::FreeStream(t.x);
+		Mesh::FreeStream(t.y);
+		Mesh::FreeStream(t.z);
+		Mesh::FreeStream(t.invW);
+
+		t.x			= (float*)Mesh::AllocateStream(m->numVertices, sizeof(float));
+		t.y			= (float*)Mesh::AllocateStream(m->numVertices, sizeof(float));
+		t.z			= (float*)Mesh::AllocateStream(m->numVertices, sizeof(float));
+		t.invW		= (float*)Mesh::AllocateStream(m->numVertices, sizeof(float));
+		t.capacity	= m->numVertices;
+	}
+	if (skinned) {
+		SkinVertices(o, m);
+		t.valid = false;	//We can't tell when the bones move
+		return;
+	}
+	screenMatrix.TransformBatch(m->positionX, m->positionY, m->positionZ, m->numVertices,
+		t.x, t.y, t.z, t.invW);
+
+	t.matrix	= screenMatrix;
+	t.mesh		= m;
+	t.changes	= o->GetChanges();
+	t.valid		= true;
+}
+
+/*
+The bones are folded into the screen transform up front - a matrix multiply per
+bone, rather than an extra transform per vertex - so skinning and projecting
+each vertex is one pass. Bones the mesh uses but the object doesn't have are
+left in the bind pose.
+*/
+void	SoftwareRasteriser::SkinVertices(RenderObject* o, const Mesh* m) {
+	TransformedVertices &t = o->GetTransformedVertices();
+
+	uint bones = min((uint)o->bones.size(), m->GetNumBones());
+
+	skinPalette.resize(m->GetNumBones());
+	for (uint b = 0; b < bones; ++b) {
+		skinPalette[b] = screenMatrix * o->bones[b];
+	}
+	for (uint b = bones; b < m->GetNumBones(); ++b) {
+		skinPalette[b] = screenMatrix;
+	}
+	SIMDKernels::Get().skinVertices(skinPalette[0].values, m->positionX, m->positionY, m->positionZ,
+		m->boneIndices, m->boneWeights, m->numVertices, t.x, t.y, t.z, t.invW);
+}
+
+Mesh*	SoftwareRasteriser::SelectLOD(Mesh* m) {
+	if (m->GetNumLODs() == 1) {
+		return m;
+	}
+	float pixelSize;
+	if (!BoxOnScreen(mvpMatrix, m->GetBoundsMin(), m->GetBoundsMax(), pixelSize)) {
+		return NULL;
+	}
+	Vector3 size	= m->GetBoundsMax() - m->GetBoundsMin();
+	float	extent	= max(size.x, max(size.y, size.z));
+
+	if (extent <= 0.0f) {
+		return m;
+	}
+	// Roughly how many pixels a unit of model space covers, to turn each
+	// level's error into how far it's off on screen
+	float pixelsPerUnit = pixelSize / extent;
+	float allowed		= pow(2.0f, meshLODBias);
+
+	uint level = 0;
+	while (level + 1 < m->GetNumLODs() && m->GetLODError(level + 1) * pixelsPerUnit <= allowed) {
+		++level;
+	}
+	return m->GetLOD(level);
+}
+
+void	SoftwareRasteriser::RasteriseTriMesh(RenderObject*o) {
+	Mesh* m = SelectLOD(o->GetMesh());
+
+	if (!m) {
+		return;
+	}
+
+	// Shared vertices only get transformed once, rather than once per triangle
+	TransformVertices(o, m);
+
+	for (uint i = 0; i + 2 < m->numVertices && !QueryAnswered(); i += 3)
+	{
+		Vector4 v0 = TransformedVertex(i);
+		Vector4 v1 = TransformedVertex(i + 1);
+		Vector4 v2 = TransformedVertex(i + 2);
+
+		Vector3 t0, t1, t2;
+		if (m->texCoordU) {
+			t0 = m->GetTexCoord(i);
+			t1 = m->GetTexCoord(i + 1);
+			t2 = m->GetTexCoord(i + 2);
+		}
+
+		RasteriseTri(v0, v1, v2,
+			m->GetColour(i),
+			m->GetColour(i + 1),
+			m->GetColour(i + 2),
+			t0, t1, t2);
+	}
+}
+
+TriangleSetup SoftwareRasteriser::SetupTriangle(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2, float triArea)
+{
+	// The weight of a vertex is the area of the sub triangle opposite it,
+	// divided by the whole area. Those sub areas are linear in x and y.
+	float areaRecip = 0.5f / triArea;
+
+	TriangleSetup t;
+
+	t.l1.dx = (v2.y - v0.y) * areaRecip;
+	t.l1.dy = (v0.x - v2.x) * areaRecip;
+	t.l1.c = ((v2.x * v0.y) - (v0.x * v2.y)) * areaRecip;
+
+	t.l2.dx = (v0.y - v1.y) * areaRecip;
+	t.l2.dy = (v1.x - v0.x) * areaRecip;
+	t.l2.c = ((v0.x * v1.y) - (v1.x * v0.y)) * areaRecip;
+
+	return t;
+}
+
+Colour SoftwareRasteriser::ShadeFragment(const AttributePlane* planes, const float* values, float texWidth, float texHeight) {
+	float w = 1.0f / values[ATTRIB_INV_W];
+
+	if (!currentTexture) {
+		return Colour(
+			(unsigned char)(values[ATTRIB_RED] * w),
+			(unsigned char)(values[ATTRIB_GREEN] * w),
+			(unsigned char)(values[ATTRIB_BLUE] * w),
+			(unsigned char)(values[ATTRIB_ALPHA] * w));
+	}
+	float u = values[ATTRIB_TEX_U] * w;
+	float v = values[ATTRIB_TEX_V] * w;
+
+	// How far we move across the texture per pixel, from the
+	// derivative of (u/w) / (1/w). The larger of the two axes
+	// picks the mip level.
+	float dudx = (planes[ATTRIB_TEX_U].dx - u * planes[ATTRIB_INV_W].dx) * w * texWidth;
+	float dvdx = (planes[ATTRIB_TEX_V].dx - v * planes[ATTRIB_INV_W].dx) * w * texHeight;
+	float dudy = (planes[ATTRIB_TEX_U].dy - u * planes[ATTRIB_INV_W].dy) * w * texWidth;
+	float dvdy = (planes[ATTRIB_TEX_V].dy - v * planes[ATTRIB_INV_W].dy) * w * texHeight;
+
+	float rho = max((dudx * dudx) + (dvdx * dvdx), (dudy * dudy) + (dvdy * dvdy));
+	float lod = 0.5f * log2(max(rho, 1.0f)); //log2 of the square root
+
+	return currentTexture->SampleTexture(Vector3(u, v, 0.0f), lod, texSampleState);
+}
+
+/*
+Every pixel in a block gets whatever the first of them to be drawn worked out.
+That pixel's always inside the triangle, unlike the middle of the block, so we
+never get colours from off the edge of it. The block keeps the mip level its
+first pixel picked, as a bigger one would just blur it even more.
+*/
+Colour SoftwareRasteriser::CoarseFragment(int x, int y, const AttributePlane* planes, const float* values,
+	float texWidth, float texHeight) {
+	int rate	= max((int)shadingRate, (int)ShadingRateAt(x, y));
+	int blockX	= x - (x % rate);
+	int blockY	= y - (y % rate);
+
+	CoarseSample &s = coarseSamples[blockX];
+	if (s.triangle != coarseTriangle || s.y != blockY) {
+		s.colour	= ShadeFragment(planes, values, texWidth, texHeight);
+		s.triangle	= coarseTriangle;
+		s.y			= blockY;
+	}
+	return s.colour;
+}
+
+void SoftwareRasteriser::AddShadingRegion(const Vector2 &topLeft, const Vector2 &bottomRight, ShadingRate rate) {
+	ShadingRegion r = { topLeft, bottomRight, rate };
+	shadingRegions.push_back(r);
+	shadingTilesDirty	= true;
+	lastFrameValid		= false;
+}
+
+void SoftwareRasteriser::ClearShadingRegions() {
+	shadingRegions.clear();
+	shadingTilesDirty	= true;
+	lastFrameValid		= false;
+}
+
+void SoftwareRasteriser::UpdateShadingTiles() {
+	shadingTilesDirty = false;
+	shadingTiles.clear();
+
+	if (shadingRegions.empty()) {
+		return;
+	}
+	int tilesWide = (renderWidth  + SHADING_TILE_SIZE - 1) / SHADING_TILE_SIZE;
+	int tilesHigh = (renderHeight + SHADING_TILE_SIZE - 1) / SHADING_TILE_SIZE;
+
+	shadingTilesWide = tilesWide;
+	shadingTiles.assign(tilesWide * tilesHigh, SHADING_1X1);
+
+	//Any tile the region touches gets its rate
+	for (vector<ShadingRegion>::iterator i = shadingRegions.begin(); i != shadingRegions.end(); ++i) {
+		int left	= max((int)floor(i->topLeft.x * renderWidth),  0);
+		int top		= max((int)floor(i->topLeft.y * renderHeight), 0);
+		int right	= min((int)ceil(i->bottomRight.x * renderWidth),  (int)renderWidth);
+		int bottom	= min((int)ceil(i->bottomRight.y * renderHeight), (int)renderHeight);
+
+		if (right <= left || bottom <= top) {
+			continue;
+		}
+		left	/= SHADING_TILE_SIZE;
+		top		/= SHADING_TILE_SIZE;
+		right	= (right  - 1) / SHADING_TILE_SIZE;
+		bottom	= (bottom - 1) / SHADING_TILE_SIZE;
+
+		for (int y = top; y <= bottom; ++y) {
+			for (int x = left; x <= right; ++x) {
+				unsigned char &tile = shadingTiles[(y * tilesWide) + x];
+				tile = max(tile, (unsigned char)i->rate);
+			}
+		}
+	}
+}
+
+void SoftwareRasteriser::RasteriseTri(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2,
+	const Colour &colA, const Colour &colB, const Colour &colC,
+	const Vector3 &texA, const Vector3 &texB, const Vector3 &texC)
+{
+	if (!colourWrite) {
+		RasteriseDepthTri(v0, v1, v2);
+		return;
+	}
+	//Incoming triangles are already on screen, with 1/w in w. That's 0
+	//for anything that was behind the camera
+	if (v0.w <= 0.0f || v1.w <= 0.0f || v2.w <= 0.0f) {
+		return; // Crosses behind the camera, and we don't clip yet
+	}
+
+	float invW[3] = { v0.w, v1.w, v2.w };
+
+	float triArea = ScreenAreaOfTri(v0, v1, v2);
+
+	if (abs(triArea) < 1.0f) {
+		return; // Tiny triangle we don't care about...
+	}
+
+	BoundingBox b = CalculateBoxForTri(v0, v1, v2);
+
+	int xMin = (int)ceil(b.topLeft.x);
+	int yMin = (int)ceil(b.topLeft.y);
+	int xMax = min((int)b.bottomRight.x, scissor.right - 1);
+	int yMax = min((int)b.bottomRight.y, scissor.bottom - 1);
+
+	// Build every plane up front. Anything that should look right in
+	// perspective is interpolated as a/w, alongside 1/w itself.
+	TriangleSetup setup = SetupTriangle(v0, v1, v2, triArea);
+
+	AttributePlane planes[ATTRIB_MAX];
+	planes[ATTRIB_INV_W]	= setup.Plane(invW[0], invW[1], invW[2]);
+	planes[ATTRIB_DEPTH]	= setup.Plane(v0.z, v1.z, v2.z);
+	planes[ATTRIB_RED]		= setup.Plane(colA.r * invW[0], colB.r * invW[1], colC.r * invW[2]);
+	planes[ATTRIB_GREEN]	= setup.Plane(colA.g * invW[0], colB.g * invW[1], colC.g * invW[2]);
+	planes[ATTRIB_BLUE]		= setup.Plane(colA.b * invW[0], colB.b * invW[1], colC.b * invW[2]);
+	planes[ATTRIB_ALPHA]	= setup.Plane(colA.a * invW[0], colB.a * invW[1], colC.a * invW[2]);
+	planes[ATTRIB_TEX_U]	= setup.Plane(texA.x * invW[0], texB.x * invW[1], texC.x * invW[2]);
+	planes[ATTRIB_TEX_V]	= setup.Plane(texA.y * invW[0], texB.y * invW[1], texC.y * invW[2]);
+
+	float values[ATTRIB_MAX];
+
+	if (shadingTilesDirty) {
+		UpdateShadingTiles();
+	}
+	bool coarse = (shadingRate != SHADING_1X1) || !shadingTiles.empty();
+	if (coarse) {
+		++coarseTriangle; //Nothing from the last triangle can be reused
+	}
+
+	float texWidth	= currentTexture ? (float)currentTexture->GetWidth()  : 0.0f;
+	float texHeight = currentTexture ? (float)currentTexture->GetHeight() : 0.0f;
+
+	const SIMDKernelTable &simd = SIMDKernels::Get();
+
+	for (int y = yMin; y <= yMax && !QueryAnswered(); ++y)
+	{
+		// Find which part of the row is actually inside the triangle - the
+		// rest of the bounding box is skipped a whole SIMD register at a time
+		int first;
+		int last;
+		if (!simd.triangleSpan(setup.l1.At((float)xMin, (float)y), setup.l2.At((float)xMin, (float)y),
+			setup.l1.dx, setup.l2.dx, xMax - xMin + 1, first, last)) {
+			continue;
+		}
+		int spanStart	= xMin + first;
+		int spanEnd		= xMin + last;
+
+		// Evaluate everything once at the start of the span...
+		for (int i = 0; i < ATTRIB_MAX; ++i) {
+			values[i] = planes[i].At((float)spanStart, (float)y);
+		}
+		// ...apart from depth, which is worked out from the start for every
+		// pixel, so it's exactly the same as RasteriseDepthTri's
+		float depthStart = values[ATTRIB_DEPTH];
+
+		for (int x = spanStart; x <= spanEnd; ++x)
+		{
+			if (DepthFunc(x, y, depthStart + (float)(x - spanStart) * planes[ATTRIB_DEPTH].dx))
+			{
+				ShadePixel((uint)x, (uint)y, coarse ?
+					CoarseFragment(x, y, planes, values, texWidth, texHeight) :
+					ShadeFragment(planes, values, texWidth, texHeight));
+			}
+			// ...then it's just adds to move along to the next pixel
+			for (int i = 0; i < ATTRIB_MAX; ++i) {
+				values[i] += planes[i].dx;
+			}
+		}
+	}
+}
+
+/*
+The same triangle as RasteriseTri would draw, but there's only one plane to
+set up, and whole spans of depth are tested and written at once.
+*/
+void SoftwareRasteriser::RasteriseDepthTri(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2) {
+	if (v0.w <= 0.0f || v1.w <= 0.0f || v2.w <= 0.0f) {
+		return;
+	}
+	float triArea = ScreenAreaOfTri(v0, v1, v2);
+
+	if (abs(triArea) < 1.0f) {
+		return;
+	}
+	BoundingBox b = CalculateBoxForTri(v0, v1, v2);
+
+	int xMin = (int)ceil(b.topLeft.x);
+	int yMin = (int)ceil(b.topLeft.y);
+	int xMax = min((int)b.bottomRight.x, scissor.right - 1);
+	int yMax = min((int)b.bottomRight.y, scissor.bottom - 1);
+
+	TriangleSetup	setup = SetupTriangle(v0, v1, v2, triArea);
+	AttributePlane	depth = setup.Plane(v0.z, v1.z, v2.z);
+
+	//An any samples query doesn't want anything drawn
+	bool write = depthWrite && !(queryActive && queryType == QUERY_ANY_SAMPLES_PASSED);
+
+	const SIMDKernelTable &simd = SIMDKernels::Get();
+
+	for (int y = yMin; y <= yMax && !QueryAnswered(); ++y)
+	{
+		int first;
+		int last;
+		if (!simd.triangleSpan(setup.l1.At((float)xMin, (float)y), setup.l2.At((float)xMin, (float)y),
+			setup.l1.dx, setup.l2.dx, xMax - xMin + 1, first, last)) {
+			continue;
+		}
+		int spanStart = xMin + first;
+
+		int passed = simd.depthSpan(&depthBuffer[(y * renderWidth) + spanStart], last - first + 1,
+			depth.At((float)spanStart, (float)y), depth.dx, depthTest, write);
+
+		if (queryActive) {
+			querySamples += passed;
+		}
+	}
+}
+
+void SoftwareRasteriser::RasteriseTriFanMesh(RenderObject*o){
+	Mesh* m = o->GetMesh();
+
+	if (m->numVertices < 3) {
+		return;
+	}
+	TransformVertices(o, m);
+
+	Vector4 v0 = TransformedVertex(0);
+
+	for (uint i = 1; i + 1 < m->numVertices && !QueryAnswered(); ++i)
+	{
+		Vector4 v1 = TransformedVertex(i);
+		Vector4 v2 = TransformedVertex(i + 1);
+
+		RasteriseTri(v0, v1, v2,
+			m->GetColour(0),
+			m->GetColour(i),
+			m->GetColour(i + 1)
+			);
+	}
 }
\ No newline at end of file
@@ -1,130 +1,558 @@
-/******************************************************************************
-Class:SoftwareRasteriser
-Implements:Window
-Author:Rich Davison	<richard.davison4@newcastle.ac.uk>
-Description: Class to encapsulate the various rasterisation techniques looked
-at in the course material.
-
-This is the class you'll be modifying the most!
-
--_-_-_-_-_-_-_,------,   
-_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
--_-_-_-_-_-_-~|__( ^ .^) /
-_-_-_-_-_-_-_-""  ""   
-
-*//////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "Matrix4.h"
-#include "Mesh.h"
-#include "Texture.h"
-#include "RenderObject.h"
-#include "Common.h"
-#include "Window.h"
-
-#include <vector>
-
-using std::vector;
-
-struct BoundingBox {
-	Vector2 topLeft;
-	Vector2 bottomRight;
-};
-
-class RenderObject;
-class Texture;
-
-class SoftwareRasteriser : public Window	{
-public:
-	SoftwareRasteriser(uint width, uint height);
-	~SoftwareRasteriser(void);
-
-	void	DrawObject(RenderObject*o);
-
-	void	ClearBuffers();
-	void	SwapBuffers();
-
-	void	SetViewMatrix(const Matrix4 &m) {
-		viewMatrix		= m;
-		viewProjMatrix	= projectionMatrix * viewMatrix;
-	}
-	
-	inline void	SetProjectionMatrix(const Matrix4 &m) {
-		projectionMatrix	= m;
-		viewProjMatrix		= projectionMatrix * viewMatrix;
-	}
-
-	static float ScreenAreaOfTri(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2);
-
-protected:
-	Colour*	GetCurrentBuffer();
-
-	void	RasterisePointsMesh(RenderObject*o);
-	void	RasteriseLinesMesh(RenderObject*o);
-
-	/*NEW PRIMITIVE FUNCTIONS*/
-
-	void RasteriseLinestripMesh(RenderObject*o);
-	void RasteriseLineloopMesh(RenderObject*o);
-
-	void RasteriseTriFanMesh(RenderObject*o);
-
-	/*BACK TO WHERE YOU WERE*/
-
-	inline bool DepthFunc(int x, int y, float depthValue){
-		int index = (y * screenWidth) + x;
-
-		unsigned int castVal = (unsigned int)depthValue;
-
-		if (castVal > depthBuffer[index]){
-			return false;
-		}
-		depthBuffer[index] = castVal;
-		return true;
-	}
-
-	virtual void Resize();
-
-	void	RasteriseLine(const Vector4 &vertA, const Vector4 &vertB,
-		const Colour &colA = Colour(255,255,255,255), const Colour &colB = Colour(255,255,255,255), 
-		const Vector2 &texA = Vector2(0,0) , const Vector2 &texB = Vector2(1,1));
-	
-	inline void	ShadePixel(uint x, uint y, const Colour&c) {
-		if(y >= screenHeight) {
-			return;
-		}
-		if(x >= screenWidth) {
-			return;
-		}
-
-		int index =  (y * screenWidth) + x;
-
-		buffers[currentDrawBuffer][index] = c;
-	}
-
-
-	void	RasteriseTriMesh(RenderObject*o);
-
-	void	RasteriseTri(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2, 
-		const Colour &c0 = Colour(), const Colour &c1 = Colour(), const Colour &c2= Colour(),
-		const Vector3 &t0 = Vector3(), const Vector3 &t1= Vector3(), const Vector3 &t2	= Vector3());
-	
-	int		currentDrawBuffer;
-
-	Colour*	buffers[2];
-
-	unsigned short*	depthBuffer;
-
-	Matrix4 viewMatrix;
-	Matrix4 projectionMatrix;
-	Matrix4 textureMatrix;
-
-	Matrix4	viewProjMatrix;
-
-	Matrix4	portMatrix;
-	
-	BoundingBox CalculateBoxForTri(const Vector4 &a, const Vector4 &b, const Vector4 &c);
-
-};
-
+/******************************************************************************
+Class:SoftwareRasteriser
+Implements:Window
+Author:Rich Davison	<richard.davison4@newcastle.ac.uk>
+Description: Class to encapsulate the various rasterisation techniques looked
+at in the course material.
+
+This is the class you'll be modifying the most!
+
+-_-_-_-_-_-_-_,------,   
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""   
+
+*//////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Matrix4.h"
+#include "Mesh.h"
+#include "Texture.h"
+#include "RenderObject.h"
+#include "SceneNode.h"
+#include "OcclusionBuffer.h"
+#include "DepthTarget.h"
+#include "RenderTarget.h"
+#include "Common.h"
+#include "Window.h"
+
+#include <vector>
+
+using std::vector;
+
+//Any smaller and there's hardly anything left to look at
+#define MIN_RENDER_SCALE 0.25f
+
+//Shading regions are rounded out to tiles this big. It's a multiple of the
+//biggest shading block, so a block never has two rates in it
+#define SHADING_TILE_SIZE 16
+
+//Incremental rendering gives up and draws everything if there's more than this
+//many separate parts of the screen to redraw, or they cover most of it
+#define MAX_DIRTY_RECTS 8
+
+//What an occlusion query counts - see BeginQuery
+enum QueryType {
+	QUERY_SAMPLES_PASSED,		//How many pixels passed the depth test
+	QUERY_ANY_SAMPLES_PASSED	//Whether any did - 1 or 0
+};
+
+//What EndQuery gives back when it couldn't count anything. It's not 0, so
+//code that only checks for 0 still treats the object as visible
+#define QUERY_RESULT_UNAVAILABLE 0xFFFFFFFF
+
+//A block of pixels, from (left, top) up to but not including (right, bottom)
+struct PixelRect {
+	int left;
+	int top;
+	int right;
+	int bottom;
+
+	inline bool Empty() const {
+		return right <= left || bottom <= top;
+	}
+
+	inline int Area() const {
+		return Empty() ? 0 : (right - left) * (bottom - top);
+	}
+
+	inline bool Overlaps(const PixelRect &r) const {
+		return left < r.right && r.left < right && top < r.bottom && r.top < bottom;
+	}
+
+	inline PixelRect Union(const PixelRect &r) const {
+		PixelRect u = { min(left, r.left), min(top, r.top), max(right, r.right), max(bottom, r.bottom) };
+		return u;
+	}
+
+	inline PixelRect Intersection(const PixelRect &r) const {
+		PixelRect i = { max(left, r.left), max(top, r.top), min(right, r.right), min(bottom, r.bottom) };
+		return i;
+	}
+};
+
+struct BoundingBox {
+	Vector2 topLeft;
+	Vector2 bottomRight;
+};
+
+/*
+A value that varies linearly across a triangle in screen space, stored as the
+plane a(x,y) = (dx * x) + (dy * y) + c. Building these once per triangle means
+stepping to the next pixel is just an add, rather than a 3-way blend.
+*/
+struct AttributePlane {
+	float dx;
+	float dy;
+	float c;
+
+	inline float At(float x, float y) const {
+		return (dx * x) + (dy * y) + c;
+	}
+};
+
+/*
+The barycentric weights of vertices 1 and 2 as planes - everything else about
+the triangle can be built from these two, so this work is shared between all
+of the attributes we interpolate.
+*/
+struct TriangleSetup {
+	AttributePlane l1;
+	AttributePlane l2;
+
+	inline AttributePlane Plane(float a0, float a1, float a2) const {
+		AttributePlane p;
+		p.dx = ((a1 - a0) * l1.dx) + ((a2 - a0) * l2.dx);
+		p.dy = ((a1 - a0) * l1.dy) + ((a2 - a0) * l2.dy);
+		p.c  = a0 + ((a1 - a0) * l1.c) + ((a2 - a0) * l2.c);
+		return p;
+	}
+};
+
+//Everything RasteriseTri interpolates. Apart from depth (which is already
+//linear in screen space) these are all stored divided by w
+enum TriangleAttribute {
+	ATTRIB_INV_W,
+	ATTRIB_DEPTH,
+	ATTRIB_RED,
+	ATTRIB_GREEN,
+	ATTRIB_BLUE,
+	ATTRIB_ALPHA,
+	ATTRIB_TEX_U,
+	ATTRIB_TEX_V,
+	ATTRIB_MAX
+};
+
+//A part of the screen (from 0 to 1 across and down, so it doesn't care about
+//the render scale) that's shaded at a lower rate
+struct ShadingRegion {
+	Vector2		topLeft;
+	Vector2		bottomRight;
+	ShadingRate	rate;
+};
+
+//The colour worked out for a shading block, and which block it was for
+struct CoarseSample {
+	Colour	colour;
+	uint	triangle;
+	int		y;
+};
+
+class RenderObject;
+
+/*
+Everything about a DrawObject call that changes what ends up on screen. In
+incremental mode, these are kept until SwapBuffers, and last frame's are
+compared against this frame's to see what needs redrawing. Last frame's
+object pointers are only ever compared, never used - they might be deleted!
+*/
+struct QueuedDraw {
+	RenderObject*	object;
+	uint			changes;		//The object's change count, see RenderObject::MarkChanged
+	bool			animated;		//Skinned, or a point cloud - these always count as changed
+
+	Matrix4			mvp;
+	Mesh*			mesh;
+	PointCloud*		cloud;
+	Texture*		texture;
+	LineMode		lineMode;
+	float			lineWidth;
+	float			pointSize;
+	ShadingRate		shadingRate;
+
+	bool			depthTest;
+	bool			depthWrite;
+	bool			depthOnly;
+	SampleState		sampleState;
+	float			lodBias;
+
+	PixelRect		rect;			//The part of the screen it can touch
+};
+class Texture;
+
+class SoftwareRasteriser : public Window	{
+public:
+	SoftwareRasteriser(uint width, uint height);
+	~SoftwareRasteriser(void);
+
+	void	DrawObject(RenderObject*o);
+	//Brings the node's world transforms up to date, then draws it and
+	//everything below it that has a RenderObject
+	void	DrawNode(SceneNode*n);
+
+	/*
+	Occlusion culling. Draw the big things that hide lots of others (walls,
+	buildings, ship hulls) with DrawOccluder first, after ClearBuffers - that
+	draws their occluder mesh (or their mesh, if they don't have one) into a
+	small depth buffer. Any object drawn after that whose box is entirely
+	behind them is skipped, before any of its vertices are transformed.
+
+	Occluders aren't drawn to the screen - DrawObject them as well! Skinned
+	meshes need an occluder of their own, as their mesh is in the bind pose.
+	DrawOccluder does nothing while a render or depth target is set.
+	*/
+	void	DrawOccluder(RenderObject*o);
+	//How many objects have been skipped since ClearBuffers
+	uint	GetOccludedCount() const { return occludedCount;}
+
+	/*
+	Occlusion queries, like OpenGL's. The pixels of everything drawn between
+	BeginQuery and EndQuery that pass the depth test are counted, and EndQuery
+	tells you how many there were. Draw a bounding box, say, to find out if the
+	expensive thing inside it is worth bothering with.
+
+	QUERY_ANY_SAMPLES_PASSED only wants to know if there were any at all, so
+	it stops drawing as soon as it finds one - which means it can't leave
+	anything half drawn, so it doesn't draw anything (not even depth).
+
+	Incremental rendering doesn't draw anything until SwapBuffers, so queries
+	can't see anything - EndQuery returns QUERY_RESULT_UNAVAILABLE for both
+	types, rather than a made up count. Check for it before using the result
+	as a number! Anything drawn during an any samples query is dropped, rather
+	than drawn later. Queries drawn into a render or depth target still count
+	as normal, as they're drawn straight away.
+	*/
+	void	BeginQuery(QueryType type = QUERY_SAMPLES_PASSED);
+	uint	EndQuery();
+
+	/*
+	Incremental rendering, for frames where hardly anything changes. Objects
+	aren't drawn straight away, but remembered until SwapBuffers, and compared
+	against the objects drawn last frame - in the same order. Only the parts of
+	the screen that a changed object was or now is in get cleared and drawn
+	again, and only those rows get sent to the window. The rest of the frame is
+	left over from last time.
+
+	Everything still has to be drawn every frame, even if it hasn't moved, so
+	we know it's still there! Don't change objects between drawing them and
+	SwapBuffers, and call MarkChanged on them if you edit their mesh or texture.
+	*/
+	void	SetIncrementalRendering(bool enabled);
+	bool	GetIncrementalRendering() const { return incremental;}
+
+	void	ClearBuffers();
+	void	SwapBuffers();
+
+	void	SetViewMatrix(const Matrix4 &m) {
+		viewMatrix		= m;
+		viewProjMatrix	= projectionMatrix * viewMatrix;
+	}
+	
+	inline void	SetProjectionMatrix(const Matrix4 &m) {
+		projectionMatrix	= m;
+		viewProjMatrix		= projectionMatrix * viewMatrix;
+	}
+
+	void	SetTextureSampleState(SampleState s) {
+		texSampleState = s;
+	}
+
+	//Turning off the depth write is handy for things like star fields,
+	//which should be hidden by solid objects but never hide anything themselves
+	void	SetDepthState(bool test, bool write) {
+		depthTest	= test;
+		depthWrite	= write;
+	}
+
+	//Only depth is drawn - no colours, textures or shading at all, and
+	//triangles go through a much quicker path that only does depth. Handy for
+	//a depth prepass, so the expensive shading only happens for the pixels
+	//that end up on screen: draw everything depth only first, then again
+	//normally (with the depth test still on).
+	void	SetDepthOnly(bool enabled) {
+		depthOnly	= enabled;
+		colourWrite = !depthOnly && (renderTarget || !depthTarget);
+	}
+
+	//Draws go into t instead of the screen, until you set it back to NULL.
+	//ClearBuffers clears it, rather than the screen, while it's set. They're
+	//drawn straight away, even in incremental mode, and aren't occlusion
+	//culled - that's only for the screen's view. Only one of each can be set
+	//at once - setting one unsets the other
+	void	SetRenderTarget(RenderTarget* t);
+	RenderTarget*	GetRenderTarget() const { return renderTarget;}
+
+	//The same, for a depth buffer on its own - everything's depth only
+	void	SetDepthTarget(DepthTarget* t);
+	DepthTarget*	GetDepthTarget() const { return depthTarget;}
+
+	//Meshes with LODs are drawn at the simplest level that strays less than
+	//2^bias pixels from the full mesh. Raise it to trade quality for speed
+	void	SetMeshLODBias(float bias) {
+		meshLODBias = bias;
+	}
+
+	/*
+	Dynamic resolution. Everything is drawn at renderScale times the size of
+	the window, then stretched back up to fill it when the frame's presented.
+	Change it between frames, not halfway through drawing one!
+
+	With a frame time budget (in milliseconds), the scale is worked out for
+	you every SwapBuffers, to keep frames inside the budget - but it never
+	goes below minScale. A budget of 0 turns that off again.
+	*/
+	void	SetRenderScale(float scale);
+	float	GetRenderScale() const { return renderScale;}
+
+	void	SetFrameTimeBudget(float milliseconds, float minScale = 0.5f);
+	//How long frames have been taking lately, in milliseconds
+	float	GetFrameTime() const { return frameTime;}
+
+	//Triangles inside any of these regions are shaded at (at least) the given
+	//rate, whatever their object asks for. Handy for the edges of the screen,
+	//or anything else that nobody's going to be looking at closely
+	void	AddShadingRegion(const Vector2 &topLeft, const Vector2 &bottomRight, ShadingRate rate);
+	void	ClearShadingRegions();
+
+	static float ScreenAreaOfTri(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2);
+
+protected:
+	inline Colour*	GetCurrentBuffer() {
+		return renderTarget ? renderTarget->colour : buffers[currentDrawBuffer];
+	}
+
+	void	RasterisePointsMesh(RenderObject*o);
+	void	RasterisePointCloud(RenderObject*o);
+	//The cloud's loaded nodes that RasterisePointCloud should draw, with the
+	//current mvpMatrix. Anything that's missing is asked for
+	void	ChoosePointCloudNodes(RenderObject*o, vector<int> &chosen);
+
+	//mvp should include the viewport transform
+	void	RasterisePoints(const Mesh* mesh, const Matrix4 &mvp);
+	void	SplatPoint(float x, float y, float depth, const Colour &c);
+	void	RasteriseLinesMesh(RenderObject*o);
+
+	/*NEW PRIMITIVE FUNCTIONS*/
+
+	void RasteriseLinestripMesh(RenderObject*o);
+	void RasteriseLineloopMesh(RenderObject*o);
+
+	void RasteriseTriFanMesh(RenderObject*o);
+
+	/*BACK TO WHERE YOU WERE*/
+
+	inline bool DepthFunc(int x, int y, float depthValue){
+		return DepthFunc((y * renderWidth) + x, depthValue);
+	}
+
+	//Pixels that are only partly covered can pass without writing any depth,
+	//or they'd hide whatever's meant to show through the rest of them
+	inline bool DepthFunc(int index, float depthValue, bool canWrite = true){
+		unsigned int castVal = (unsigned int)depthValue;
+
+		if (depthTest && castVal > depthBuffer[index]){
+			return false;
+		}
+		if (queryActive) {
+			++querySamples;
+			if (queryType == QUERY_ANY_SAMPLES_PASSED) {
+				return false;	//Just looking!
+			}
+		}
+		if (depthWrite && canWrite) {
+			depthBuffer[index] = castVal;
+		}
+		return colourWrite;
+	}
+
+	//An any samples query has its answer, so there's no point drawing more
+	inline bool QueryAnswered() const {
+		return queryActive && queryType == QUERY_ANY_SAMPLES_PASSED && querySamples > 0;
+	}
+
+	virtual void Resize();
+
+	//Takes clip space vertices, so the line can be cut at the near and far planes
+	void	RasteriseLine(const Vector4 &vertA, const Vector4 &vertB,
+		const Colour &colA = Colour(255,255,255,255), const Colour &colB = Colour(255,255,255,255), 
+		const Vector2 &texA = Vector2(0,0) , const Vector2 &texB = Vector2(1,1));
+	
+	//The three ways of filling in a screen space line - Bresenham, Wu, and
+	//rows of spans across a rectangle for lines more than a pixel wide
+	void	RasteriseSolidLine(const Vector4 &v0, const Vector4 &v1, const Colour &c0, const Colour &c1);
+	void	RasteriseSmoothLine(const Vector4 &v0, const Vector4 &v1, const Colour &c0, const Colour &c1);
+	void	RasteriseWideLine(const Vector4 &v0, const Vector4 &v1, const Colour &c0, const Colour &c1);
+
+	//Cuts a screen space line down to the part that's on screen. t0 and t1
+	//are how far along the original line the new ends are
+	bool	ClipLineToViewport(Vector4 &v0, Vector4 &v1, float &t0, float &t1);
+
+	//Mixes c into the buffer by how much of the pixel is covered. Only
+	//pixels that are at least half covered write depth
+	inline void BlendPixel(int index, float depthValue, const Colour &c, float coverage) {
+		if (coverage > 0.0f && DepthFunc(index, depthValue, coverage >= 0.5f)) {
+			Colour &dest = GetCurrentBuffer()[index];
+			dest = Colour::Lerp(dest, c, min(coverage, 1.0f));
+		}
+	}
+
+	inline void	ShadePixel(uint x, uint y, const Colour&c) {
+		if((int)y < scissor.top || (int)y >= scissor.bottom) {
+			return;
+		}
+		if((int)x < scissor.left || (int)x >= scissor.right) {
+			return;
+		}
+
+		int index =  (y * renderWidth) + x;
+
+		GetCurrentBuffer()[index] = c;
+	}
+
+
+	void	RasteriseTriMesh(RenderObject*o);
+
+	//Which of m's LODs to draw this frame, or NULL if it's off screen
+	Mesh*	SelectLOD(Mesh* m);
+
+	//Takes screen space vertices, with 1/w in w - that's needed to interpolate perspective correctly
+	void	RasteriseTri(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2, 
+		const Colour &c0 = Colour(), const Colour &c1 = Colour(), const Colour &c2= Colour(),
+		const Vector3 &t0 = Vector3(), const Vector3 &t1= Vector3(), const Vector3 &t2	= Vector3());
+	//RasteriseTri, when there's no colour to draw
+	void	RasteriseDepthTri(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2);
+
+	//The colour of a pixel inside a triangle, from its interpolated attributes
+	Colour	ShadeFragment(const AttributePlane* planes, const float* values, float texWidth, float texHeight);
+	//The same, but shared between every pixel in a shading block
+	Colour	CoarseFragment(int x, int y, const AttributePlane* planes, const float* values, float texWidth, float texHeight);
+
+	inline ShadingRate	ShadingRateAt(int x, int y) const {
+		if (shadingTiles.empty()) {
+			return SHADING_1X1;
+		}
+		return (ShadingRate)shadingTiles[((y / SHADING_TILE_SIZE) * shadingTilesWide) + (x / SHADING_TILE_SIZE)];
+	}
+	//Turns the shading regions into tiles at the current render size
+	void	UpdateShadingTiles();
+
+	//Puts every vertex of m (which is o's mesh, or one of its LODs) through
+	//screenMatrix, in one batch - unless o already has them from last time
+	void	TransformVertices(RenderObject* o, const Mesh* m);
+	//The same, for skinned meshes, with o's bones
+	void	SkinVertices(RenderObject* o, const Mesh* m);
+
+	inline Vector4 TransformedVertex(uint i) const {
+		return Vector4(transformed->x[i], transformed->y[i], transformed->z[i], transformed->invW[i]);
+	}
+
+	TriangleSetup SetupTriangle(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2, float triArea);
+	
+	int		currentDrawBuffer;
+
+	Colour*	buffers[2];
+
+	unsigned short*	depthBuffer;		//Whichever one we're drawing into
+	unsigned short*	screenDepthBuffer;
+
+	RenderTarget*	renderTarget;
+	DepthTarget*	depthTarget;	//The render target's, if there is one. NULL for the screen
+
+	Texture*	currentTexture;
+	SampleState	texSampleState;
+
+	bool	depthTest;
+	bool	depthWrite;
+	bool	depthOnly;
+	bool	colourWrite;	//False if depth only, for whatever reason
+
+	LineMode	lineMode;
+	float		lineWidth;
+	float		pointSize;
+	ShadingRate	shadingRate;
+
+	vector<ShadingRegion>	shadingRegions;
+	vector<unsigned char>	shadingTiles;	//Empty if there aren't any regions
+	uint					shadingTilesWide;
+	bool					shadingTilesDirty;
+
+	vector<CoarseSample>	coarseSamples;	//One per column, for the block that starts there
+	uint					coarseTriangle;
+
+	Matrix4 viewMatrix;
+	Matrix4 projectionMatrix;
+	Matrix4 textureMatrix;
+
+	Matrix4	viewProjMatrix;
+
+	//Worked out once per DrawObject, for the object being drawn
+	Matrix4	mvpMatrix;		//To clip space
+	Matrix4	screenMatrix;	//Straight to the screen, with portMatrix included
+
+	const TransformedVertices* transformed;	//Whichever object's we're drawing
+
+	vector<Matrix4>	skinPalette;	//An object's bones, with screenMatrix included
+
+	OcclusionBuffer	occlusion;
+	uint			occludedCount;
+
+	bool			queryActive;
+	QueryType		queryType;
+	uint			querySamples;
+
+	float	meshLODBias;
+
+	void	UpdateRenderScale();
+	void	UpscaleBuffer(const Colour* src, Colour* dest);
+
+	//Everything that depends on the size of what we're drawing into
+	void	SetViewport(uint width, uint height);
+	//Points everything at whatever targets are set (or the screen)
+	void	UseTargets();
+
+	uint	renderWidth;
+	uint	renderHeight;
+	float	renderScale;
+	float	minRenderScale;
+	float	frameBudget;
+	float	frameTime;
+	double	lastFrameStart;
+
+	Matrix4	portMatrix;
+	
+	//False if the box is entirely outside the view. Otherwise, pixelSize is
+	//how big it is on screen - or FLT_MAX if it's partly behind the camera
+	bool	BoxOnScreen(const Matrix4 &mvp, const Vector3 &boxMin, const Vector3 &boxMax, float &pixelSize);
+	//The same, but also giving the pixels it covers. That's the whole screen if
+	//it's partly behind the camera, as there's no sensible edge to give
+	bool	BoxOnScreen(const Matrix4 &mvp, const Vector3 &boxMin, const Vector3 &boxMax, float &pixelSize, PixelRect &rect);
+
+	//DrawNode, minus the Update
+	void	DrawSubtree(SceneNode*n);
+
+	//Actually draws an object, with mvp instead of its own model matrix
+	void	DrawObjectNow(RenderObject*o, const Matrix4 &mvp);
+
+	QueuedDraw	QueueDraw(RenderObject*o);
+	bool		DrawChanged(const QueuedDraw &now, const QueuedDraw &last) const;
+	//Works out what's changed since last frame, and draws just that
+	void		DrawIncremental();
+	void		ClearRect(const PixelRect &r);
+
+	PixelRect	scissor;	//Nothing's drawn outside of this
+
+	bool				incremental;
+	bool				lastFrameValid;	//False if everything needs drawing again
+	vector<QueuedDraw>	drawQueue;
+	vector<QueuedDraw>	lastDraws;
+	vector<PixelRect>	dirtyRects;
+
+	vector<vector<int> >	queuedCloudNodes;	//Chosen once a frame, per queued draw
+	const vector<int>*		chosenCloudNodes;	//If set, drawn instead of choosing again
+	vector<int>				cloudNodes;
+
+	BoundingBox CalculateBoxForTri(const Vector4 &a, const Vector4 &b, const Vector4 &c);
+
+};
+
@@ -1,42 +1,689 @@
-#include "Texture.h"
-
-Texture::Texture(void)	{
-	width	= 0;
-	height	= 0;
-
-	texels = NULL;
-}
-
-Texture::~Texture(void)	{
-	delete[] texels;
-}
-
-Texture* Texture::TextureFromTGA(const string &filename) {
-	Texture * t = new Texture();
-	std::ifstream file;
-
-	std::cout << "Loading TGA from(" << filename << ")" << std::endl;
-	file.open(filename.c_str(), std::ios::binary);
-	if(!file.is_open()){
-		std::cout << "TextureFromTGA file error" << std::endl;
-		return t ;
-	}
-
-	unsigned char TGAheader[18];
-
-	std::cout << "sizeof(TGAheader) is " << sizeof(TGAheader) << std::endl;
-
-	file.read((char*)TGAheader,sizeof(TGAheader));
-
-	t->width	= (TGAheader[12] + (TGAheader[13] << 8));
-	t->height	= (TGAheader[14] + (TGAheader[15] << 8));
-
-	int size = t->width * t->height * (TGAheader[16] / 8);
-
-	t->texels = new Colour[t->width*t->height];
-
-	file.read( (char*) t->texels ,size);
-	file.close();
-
-	return t;
+#include "Texture.h"
+#include "TextureManager.h"
+#include "MappedFile.h"
+#include "SIMDKernels.h"
+#include <atomic>
+#include <climits>
+
+Texture::Texture(void)	{
+	width	= 0;
+	height	= 0;
+
+	mipLevels = 0;
+	layout	  = TEXTURE_LAYOUT_LINEAR;
+	format	  = TEXTURE_FORMAT_RGBA8;
+	manager	  = NULL;
+
+	memset(levels, 0, sizeof(levels));
+	memset(levelLastUsed, 0, sizeof(levelLastUsed));
+}
+
+Texture::~Texture(void)	{
+	for (uint i = 0; i < MAX_MIP_LEVELS; ++i) {
+		FreeLevel(i);
+	}
+}
+
+/*
+TGA stores its pixels as BGR(A), which is the same order as our Colour struct,
+so 32 bit images can be copied across as they are. 24 bit ones need an alpha
+byte adding to every pixel - SSE2 can't shuffle bytes around freely, but it
+can shift the whole register, so we make 4 copies offset by one pixel each,
+and interleave them so that each lane ends up with a different pixel.
+*/
+static void ExpandBGRToColour(const unsigned char* src, Colour* dst, uint count) {
+	uint i = 0;
+
+	//Each step reads 16 bytes but only uses 12, so stop before we'd run off the end
+	if (count >= 6) {
+		__m128i alpha = _mm_set1_epi32(0xFF000000);
+
+		for (; i + 6 <= count; i += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i*)(src + (i * 3)));
+
+			__m128i p01 = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+			__m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+
+			__m128i pixels = _mm_or_si128(_mm_unpacklo_epi64(p01, p23), alpha);
+
+			_mm_storeu_si128((__m128i*)(dst + i), pixels);
+		}
+	}
+	for (; i < count; ++i) {
+		dst[i].b = src[(i * 3)];
+		dst[i].g = src[(i * 3) + 1];
+		dst[i].r = src[(i * 3) + 2];
+		dst[i].a = 255;
+	}
+}
+
+static void CopyTGAPixels(const unsigned char* src, Colour* dst, uint count, uint bytesPerPixel) {
+	if (bytesPerPixel == 4) {
+		memcpy(dst, src, count * sizeof(Colour));
+	}
+	else {
+		ExpandBGRToColour(src, dst, count);
+	}
+}
+
+//Returns how many bytes of the file it used up, or 0 if it ran out of data
+static size_t DecodeRLE(const unsigned char* src, size_t srcSize, Colour* dst, uint count, uint bytesPerPixel) {
+	size_t	read	= 0;
+	uint	written = 0;
+
+	while (written < count) {
+		if (read >= srcSize) {
+			return 0;
+		}
+		unsigned char packet = src[read++];
+		uint length = min((uint)(packet & 0x7F) + 1, count - written);
+
+		if (packet & 0x80) { //Run of the same pixel
+			if (read + bytesPerPixel > srcSize) {
+				return 0;
+			}
+			Colour c;
+			CopyTGAPixels(&src[read], &c, 1, bytesPerPixel);
+			read += bytesPerPixel;
+
+			for (uint i = 0; i < length; ++i) {
+				dst[written + i] = c;
+			}
+		}
+		else { //Raw pixels
+			if (read + (length * bytesPerPixel) > srcSize) {
+				return 0;
+			}
+			CopyTGAPixels(&src[read], &dst[written], length, bytesPerPixel);
+			read += length * bytesPerPixel;
+		}
+		written += length;
+	}
+	return read;
+}
+
+Texture* Texture::TextureFromTGA(const string &filename) {
+	MappedFile file;
+
+	if (!file.Open(filename) || file.GetSize() < 18) {
+		return NULL;
+	}
+	const unsigned char* TGAheader	= file.GetData();
+	const unsigned char* fileEnd	= file.GetData() + file.GetSize();
+
+	uint idLength		= TGAheader[0];
+	uint colourMapType	= TGAheader[1];
+	uint imageType		= TGAheader[2];
+	uint colourMapSize	= (TGAheader[5] + (TGAheader[6] << 8)) * ((TGAheader[7] + 7) / 8);
+	uint bytesPerPixel	= TGAheader[16] / 8;
+	bool topToBottom	= (TGAheader[17] & 0x20) != 0;
+
+	uint width	= (TGAheader[12] + (TGAheader[13] << 8));
+	uint height = (TGAheader[14] + (TGAheader[15] << 8));
+
+	//Only truecolour images (2), and their RLE versions (10)
+	if ((imageType != 2 && imageType != 10) || (bytesPerPixel != 3 && bytesPerPixel != 4) ||
+		width == 0 || height == 0) {
+		return NULL;
+	}
+	const unsigned char* pixels = TGAheader + 18 + idLength + (colourMapType ? colourMapSize : 0);
+
+	if (pixels >= fileEnd) {
+		return NULL;
+	}
+	size_t available = (size_t)(fileEnd - pixels);
+
+	Texture* t = new Texture();
+	t->width	= width;
+	t->height	= height;
+
+	//Make room for the whole mip chain now. The file is row by row,
+	//so it's read in linear and tiled afterwards
+	t->mipLevels	= MipLevelsFor(t->width, t->height);
+	t->layout		= TEXTURE_LAYOUT_LINEAR;
+	t->AllocateLevels();
+
+	uint count = width * height;
+
+	if (imageType == 10) {
+		if (!DecodeRLE(pixels, available, t->levels[0], count, bytesPerPixel)) {
+			delete t;
+			return NULL;
+		}
+	}
+	else {
+		if (available < (size_t)count * bytesPerPixel) {
+			delete t;
+			return NULL;
+		}
+		CopyTGAPixels(pixels, t->levels[0], count, bytesPerPixel);
+	}
+
+	//Row 0 should be the bottom of the image, like the texture coordinates
+	if (topToBottom) {
+		Colour* row = new Colour[width];
+		for (uint y = 0; y < height / 2; ++y) {
+			Colour* a = &t->levels[0][y * width];
+			Colour* b = &t->levels[0][(height - 1 - y) * width];
+
+			memcpy(row, a, width * sizeof(Colour));
+			memcpy(a, b, width * sizeof(Colour));
+			memcpy(b, row, width * sizeof(Colour));
+		}
+		delete[] row;
+	}
+
+	t->GenerateMipMaps();
+	t->SetLayout(TEXTURE_LAYOUT_TILED);
+
+	return t;
+}
+
+bool Texture::TGADimensions(const string &filename, uint &width, uint &height) {
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	unsigned char TGAheader[18];
+
+	if (!file.read((char*)TGAheader, sizeof(TGAheader))) {
+		return false;
+	}
+	width	= (TGAheader[12] + (TGAheader[13] << 8));
+	height	= (TGAheader[14] + (TGAheader[15] << 8));
+
+	return true;
+}
+
+uint Texture::MipLevelsFor(uint width, uint height) {
+	uint levels = 1;
+
+	while ((width > 1 || height > 1) && levels < MAX_MIP_LEVELS) {
+		width	= max(1u, width  >> 1);
+		height	= max(1u, height >> 1);
+		levels++;
+	}
+	return levels;
+}
+
+uint Texture::LevelTexels(int mipLevel) {
+	if (layout == TEXTURE_LAYOUT_TILED) { //Partial tiles still take up a whole tile
+		return ((GetWidth(mipLevel) + 3) & ~3u) * ((GetHeight(mipLevel) + 3) & ~3u);
+	}
+	return GetWidth(mipLevel) * GetHeight(mipLevel);
+}
+
+uint Texture::LevelBytes(int mipLevel) {
+	if (format == TEXTURE_FORMAT_RGBA8) {
+		return LevelTexels(mipLevel) * sizeof(Colour);
+	}
+	uint blocks = ((GetWidth(mipLevel) + 3) >> 2) * ((GetHeight(mipLevel) + 3) >> 2);
+
+	return blocks * (format == TEXTURE_FORMAT_BC1 ? 8 : 16);
+}
+
+Colour* Texture::NewLevel(uint bytes) {
+	Colour* texels = (Colour*)AlignedAlloc(max(bytes, (uint)sizeof(Colour)), TEXTURE_LEVEL_ALIGNMENT);
+
+	for (uint i = 0; texels && i < bytes / sizeof(Colour); ++i) {
+		texels[i] = Colour();
+	}
+	return texels;
+}
+
+void Texture::DeleteLevel(Colour* texels) {
+	if (texels) {
+		AlignedFree(texels);
+	}
+}
+
+void Texture::AllocateLevels() {
+	for (uint i = 0; i < mipLevels; ++i) {
+		FreeLevel(i);
+		levels[i] = NewLevel(LevelBytes(i));
+	}
+}
+
+void Texture::RequestLevel(int mipLevel) {
+	if (manager) {
+		manager->LoadLevel(this, mipLevel);
+	}
+}
+
+void Texture::MarkUsed(int mipLevel) {
+	if (manager) {
+		levelLastUsed[mipLevel] = manager->GetFrame();
+	}
+}
+
+void Texture::SetLayout(TextureLayout newLayout) {
+	if (format != TEXTURE_FORMAT_RGBA8) {
+		return;
+	}
+	TextureLayout oldLayout = layout;
+	layout = newLayout;
+
+	if (newLayout == oldLayout) {
+		return;
+	}
+	for (uint level = 0; level < mipLevels; ++level) {
+		if (!levels[level]) {
+			continue;	//Not resident, it'll arrive in the right layout
+		}
+		uint levelWidth		= GetWidth(level);
+		uint levelHeight	= GetHeight(level);
+
+		Colour* oldTexels = levels[level];
+		Colour* newTexels = NewLevel(LevelTexels(level) * sizeof(Colour));
+
+		for (uint y = 0; y < levelHeight; ++y) {
+			for (uint x = 0; x < levelWidth; ++x) {
+				newTexels[TexelIndex(layout, levelWidth, x, y)] =
+					oldTexels[TexelIndex(oldLayout, levelWidth, x, y)];
+			}
+		}
+		levels[level] = newTexels;
+		DeleteLevel(oldTexels);
+	}
+}
+
+void Texture::GenerateMipMaps() {
+	if (format != TEXTURE_FORMAT_RGBA8) {
+		return; //Can't average blocks!
+	}
+	for (uint level = 1; level < mipLevels; ++level) {
+		uint srcWidth	= GetWidth(level - 1);
+		uint srcHeight	= GetHeight(level - 1);
+		uint dstWidth	= GetWidth(level);
+		uint dstHeight	= GetHeight(level);
+
+		for (uint y = 0; y < dstHeight; ++y) {
+			//Odd sized levels just reuse their last row / column
+			uint y0 = min(y * 2, srcHeight - 1);
+			uint y1 = min(y * 2 + 1, srcHeight - 1);
+
+			for (uint x = 0; x < dstWidth; ++x) {
+				uint x0 = min(x * 2, srcWidth - 1);
+				uint x1 = min(x * 2 + 1, srcWidth - 1);
+
+				const Colour &a = ColourAtPoint(x0, y0, level - 1);
+				const Colour &b = ColourAtPoint(x1, y0, level - 1);
+				const Colour &c = ColourAtPoint(x0, y1, level - 1);
+				const Colour &d = ColourAtPoint(x1, y1, level - 1);
+
+				//+2 so that we round rather than truncate
+				levels[level][TexelIndex(layout, dstWidth, x, y)] = Colour(
+					(unsigned char)((a.r + b.r + c.r + d.r + 2) >> 2),
+					(unsigned char)((a.g + b.g + c.g + d.g + 2) >> 2),
+					(unsigned char)((a.b + b.b + c.b + d.b + 2) >> 2),
+					(unsigned char)((a.a + b.a + c.a + d.a + 2) >> 2));
+			}
+		}
+	}
+}
+
+/*
+Filtering helpers. A Colour is 4 bytes, so the 4 texels of a bilinear
+footprint fit in a single SSE register - the SIMDKernels widen them out to
+floats, weight all of them at once, and sum.
+*/
+static inline Colour FloatsToColour(__m128 f) {
+	__m128i i = _mm_cvtps_epi32(f);
+	i = _mm_packs_epi32(i, i);
+	i = _mm_packus_epi16(i, i);
+
+	Colour c;
+	c.c = (unsigned int)_mm_cvtsi128_si32(i);
+	return c;
+}
+
+static inline __m128 BilinearFilter(Texture &t, const Vector3 &coords, int mipLevel) {
+	int texWidth	= (int)t.GetWidth(mipLevel);
+	int texHeight	= (int)t.GetHeight(mipLevel);
+
+	//Texel centres are at +0.5, so shift back to find the top left of the 2x2
+	float x = (coords.x * texWidth) - 0.5f;
+	float y = (coords.y * texHeight) - 0.5f;
+
+	float fx = floor(x);
+	float fy = floor(y);
+
+	int x0 = (int)fx;
+	int y0 = (int)fy;
+
+	float xAmount = x - fx;
+	float yAmount = y - fy;
+
+	//Take copies one at a time - compressed texels live in a cache that
+	//the next lookup might overwrite
+	unsigned int texels[4];
+	texels[0] = t.ColourAtPoint(x0,		y0,		mipLevel).c;
+	texels[1] = t.ColourAtPoint(x0 + 1, y0,		mipLevel).c;
+	texels[2] = t.ColourAtPoint(x0,		y0 + 1, mipLevel).c;
+	texels[3] = t.ColourAtPoint(x0 + 1, y0 + 1, mipLevel).c;
+
+	return SIMDKernels::Get().bilinearFilter(texels, xAmount, yAmount);
+}
+
+Colour Texture::NearestTexSample(const Vector3 &coords, int miplevel) {
+	MarkUsed(miplevel);
+
+	int x = (int)floor(coords.x * GetWidth(miplevel));
+	int y = (int)floor(coords.y * GetHeight(miplevel));
+
+	return ColourAtPoint(x, y, miplevel);
+}
+
+Colour Texture::BilinearTexSample(const Vector3 &coords, int miplevel) {
+	MarkUsed(miplevel);
+	return FloatsToColour(BilinearFilter(*this, coords, miplevel));
+}
+
+Colour Texture::TrilinearTexSample(const Vector3 &coords, float lod) {
+	lod = clamp(lod, 0.0f, (float)(mipLevels - 1));
+
+	int		level	= (int)lod;
+	float	amount	= lod - level;
+
+	MarkUsed(level);
+	__m128 upper = BilinearFilter(*this, coords, level);
+
+	if (amount == 0.0f || level + 1 >= (int)mipLevels) {
+		return FloatsToColour(upper);
+	}
+	MarkUsed(level + 1);
+	__m128 lower = BilinearFilter(*this, coords, level + 1);
+
+	//upper + (lower - upper) * amount
+	return FloatsToColour(_mm_add_ps(upper, _mm_mul_ps(_mm_sub_ps(lower, upper), _mm_set1_ps(amount))));
+}
+
+Colour Texture::SampleTexture(const Vector3 &coords, float lod, SampleState state) {
+	if (state == SAMPLE_TRILINEAR) {
+		return TrilinearTexSample(coords, lod);
+	}
+	//The others just snap to whichever level is closest
+	int level = (int)(lod + 0.5f);
+	level = clamp(level, 0, (int)mipLevels - 1);
+
+	if (state == SAMPLE_BILINEAR) {
+		return BilinearTexSample(coords, level);
+	}
+	return NearestTexSample(coords, level);
+}
+
+/*
+Block compression. Every 4x4 block of texels is stored as two endpoint colours
+in 565 format, and a 2 bit index per texel picking one of 4 colours along the
+line between them. BC3 adds a separate block for alpha, with 2 endpoint values
+and a 3 bit index per texel picking one of 8 alphas between them.
+*/
+static inline unsigned short To565(int r, int g, int b) {
+	return (unsigned short)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+//Expands both 565 endpoints back out, and fills in the 2 colours between them.
+//BC1 uses the endpoint order to switch to 3 colours + transparent, BC3 doesn't
+static inline void BC1Palette(unsigned short e0, unsigned short e1, unsigned int palette[4], bool fourColour) {
+	int r0 = (e0 >> 11) & 31, g0 = (e0 >> 5) & 63, b0 = e0 & 31;
+	int r1 = (e1 >> 11) & 31, g1 = (e1 >> 5) & 63, b1 = e1 & 31;
+
+	//Replicate the top bits into the bottom, so 31 -> 255 and not 248
+	__m128i c0 = _mm_setr_epi16((short)((b0 << 3) | (b0 >> 2)), (short)((g0 << 2) | (g0 >> 4)), (short)((r0 << 3) | (r0 >> 2)), 255, 0, 0, 0, 0);
+	__m128i c1 = _mm_setr_epi16((short)((b1 << 3) | (b1 >> 2)), (short)((g1 << 2) | (g1 >> 4)), (short)((r1 << 3) | (r1 >> 2)), 255, 0, 0, 0, 0);
+
+	__m128i c2, c3;
+	if (fourColour) {
+		//(2a + b) / 3 - multiplying by 65536 / 3 and keeping the top half divides by 3
+		__m128i third = _mm_set1_epi16(0x5556);
+		c2 = _mm_mulhi_epu16(_mm_add_epi16(_mm_add_epi16(c0, c0), c1), third);
+		c3 = _mm_mulhi_epu16(_mm_add_epi16(_mm_add_epi16(c1, c1), c0), third);
+	}
+	else {
+		c2 = _mm_srli_epi16(_mm_add_epi16(c0, c1), 1);
+		c3 = _mm_setzero_si128(); //Transparent black
+	}
+	_mm_storeu_si128((__m128i*)palette, _mm_packus_epi16(_mm_unpacklo_epi64(c0, c1), _mm_unpacklo_epi64(c2, c3)));
+}
+
+static inline void BC3AlphaPalette(unsigned char a0, unsigned char a1, unsigned char palette[8]) {
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1) {
+		for (int i = 1; i < 7; ++i) {
+			palette[i + 1] = (unsigned char)(((7 - i) * a0 + i * a1) / 7);
+		}
+	}
+	else {
+		for (int i = 1; i < 5; ++i) {
+			palette[i + 1] = (unsigned char)(((5 - i) * a0 + i * a1) / 5);
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+static void EncodeBC1(const Colour block[16], unsigned char* out) {
+	int minC[3] = { 255, 255, 255 };
+	int maxC[3] = { 0, 0, 0 };
+
+	for (int i = 0; i < 16; ++i) {
+		int c[3] = { block[i].r, block[i].g, block[i].b };
+		for (int j = 0; j < 3; ++j) {
+			minC[j] = min(minC[j], c[j]);
+			maxC[j] = max(maxC[j], c[j]);
+		}
+	}
+	//Pull the ends of the box in a bit - the extremes are rarely worth
+	//spending a whole palette entry on
+	for (int j = 0; j < 3; ++j) {
+		int inset = (maxC[j] - minC[j]) >> 4;
+		minC[j] += inset;
+		maxC[j] -= inset;
+	}
+	unsigned short e0 = To565(maxC[0], maxC[1], maxC[2]);
+	unsigned short e1 = To565(minC[0], minC[1], minC[2]);
+
+	unsigned int indices = 0;
+
+	if (e0 != e1) {
+		if (e0 < e1) { //e0 must be the larger, or it's decoded as 3 colour mode
+			unsigned short temp = e0; e0 = e1; e1 = temp;
+		}
+		unsigned int palette[4];
+		BC1Palette(e0, e1, palette, true);
+
+		for (int i = 0; i < 16; ++i) {
+			int best		= 0;
+			int bestError	= INT_MAX;
+			for (int p = 0; p < 4; ++p) {
+				const Colour &c = (const Colour&)palette[p];
+				int dr = c.r - block[i].r;
+				int dg = c.g - block[i].g;
+				int db = c.b - block[i].b;
+				int error = (dr * dr) + (dg * dg) + (db * db);
+				if (error < bestError) {
+					bestError	= error;
+					best		= p;
+				}
+			}
+			indices |= best << (i * 2);
+		}
+	}
+	out[0] = (unsigned char)(e0 & 0xFF);
+	out[1] = (unsigned char)(e0 >> 8);
+	out[2] = (unsigned char)(e1 & 0xFF);
+	out[3] = (unsigned char)(e1 >> 8);
+	memcpy(&out[4], &indices, 4);
+}
+
+static void EncodeBC3Alpha(const Colour block[16], unsigned char* out) {
+	unsigned char a0 = 0;
+	unsigned char a1 = 255;
+
+	for (int i = 0; i < 16; ++i) {
+		a0 = max(a0, block[i].a);
+		a1 = min(a1, block[i].a);
+	}
+	unsigned char palette[8];
+	BC3AlphaPalette(a0, a1, palette);
+
+	unsigned long long indices = 0;
+	if (a0 != a1) {
+		for (int i = 0; i < 16; ++i) {
+			int best		= 0;
+			int bestError	= INT_MAX;
+			for (int p = 0; p < 8; ++p) {
+				int error = abs(palette[p] - block[i].a);
+				if (error < bestError) {
+					bestError	= error;
+					best		= p;
+				}
+			}
+			indices |= (unsigned long long)best << (i * 3);
+		}
+	}
+	out[0] = a0;
+	out[1] = a1;
+	for (int i = 0; i < 6; ++i) {
+		out[2 + i] = (unsigned char)(indices >> (i * 8));
+	}
+}
+
+void Texture::Compress(TextureFormat newFormat) {
+	if (format != TEXTURE_FORMAT_RGBA8 || newFormat == TEXTURE_FORMAT_RGBA8) {
+		return;
+	}
+	uint blockBytes = (newFormat == TEXTURE_FORMAT_BC1) ? 8 : 16;
+
+	for (uint level = 0; level < mipLevels; ++level) {
+		if (!levels[level]) {
+			continue;
+		}
+		uint blocksWide = (GetWidth(level)  + 3) >> 2;
+		uint blocksHigh = (GetHeight(level) + 3) >> 2;
+
+		unsigned char* out = (unsigned char*)NewLevel(blocksWide * blocksHigh * blockBytes);
+
+		Colour block[16];
+		for (uint by = 0; by < blocksHigh; ++by) {
+			for (uint bx = 0; bx < blocksWide; ++bx) {
+				for (uint i = 0; i < 16; ++i) { //Edge blocks just repeat the last row / column
+					block[i] = ColourAtPoint((bx * 4) + (i & 3), (by * 4) + (i >> 2), level);
+				}
+				unsigned char* dst = &out[((by * blocksWide) + bx) * blockBytes];
+
+				if (newFormat == TEXTURE_FORMAT_BC3) {
+					EncodeBC3Alpha(block, dst);
+					dst += 8;
+				}
+				EncodeBC1(block, dst);
+			}
+		}
+		FreeLevel(level);
+		levels[level] = (Colour*)out;
+	}
+	format = newFormat;
+	layout = TEXTURE_LAYOUT_TILED;
+}
+
+/*
+Samplers never see the blocks - whole blocks are decoded at a time into a
+small cache, one per thread, and texels are read from there. Neighbouring
+samples nearly always land in the same block, so most lookups are hits.
+Freeing any compressed level bumps the epoch, which empties every cache,
+in case new texels end up at the same address.
+*/
+struct DecodedBlock {
+	const Colour*	data;
+	uint			block;
+	uint			epoch;
+	unsigned int	texels[16];	//Not Colours - thread locals can't have constructors
+};
+
+static const uint TEXEL_CACHE_SIZE = 64;
+
+static THREAD_LOCAL DecodedBlock texelCache[TEXEL_CACHE_SIZE];
+
+static std::atomic<uint> texelCacheEpoch(1);
+
+void Texture::FreeLevel(int mipLevel) {
+	if (levels[mipLevel] && format != TEXTURE_FORMAT_RGBA8) {
+		texelCacheEpoch++;
+	}
+	DeleteLevel(levels[mipLevel]);
+	levels[mipLevel] = NULL;
+}
+
+static void DecodeBC1(const unsigned char* src, unsigned int out[16], bool alwaysFourColour) {
+	unsigned short e0 = (unsigned short)(src[0] | (src[1] << 8));
+	unsigned short e1 = (unsigned short)(src[2] | (src[3] << 8));
+
+	unsigned int indices;
+	memcpy(&indices, &src[4], 4);
+
+	unsigned int palette[4];
+	BC1Palette(e0, e1, palette, alwaysFourColour || e0 > e1);
+
+	//Pick each row's 4 texels out of the palette with compares, rather than
+	//4 separate lookups
+	__m128i p0 = _mm_set1_epi32(palette[0]);
+	__m128i p1 = _mm_set1_epi32(palette[1]);
+	__m128i p2 = _mm_set1_epi32(palette[2]);
+	__m128i p3 = _mm_set1_epi32(palette[3]);
+
+	__m128i three	= _mm_set1_epi32(3);
+
+	for (int row = 0; row < 4; ++row) {
+		unsigned int rowBits = (indices >> (row * 8)) & 0xFF;
+
+		__m128i idx = _mm_and_si128(_mm_setr_epi32(rowBits, rowBits >> 2, rowBits >> 4, rowBits >> 6), three);
+
+		__m128i texels = _mm_and_si128(_mm_cmpeq_epi32(idx, _mm_setzero_si128()), p0);
+		texels = _mm_or_si128(texels, _mm_and_si128(_mm_cmpeq_epi32(idx, _mm_set1_epi32(1)), p1));
+		texels = _mm_or_si128(texels, _mm_and_si128(_mm_cmpeq_epi32(idx, _mm_set1_epi32(2)), p2));
+		texels = _mm_or_si128(texels, _mm_and_si128(_mm_cmpeq_epi32(idx, three), p3));
+
+		_mm_storeu_si128((__m128i*)&out[row * 4], texels);
+	}
+}
+
+static void DecodeBC3(const unsigned char* src, unsigned int out[16]) {
+	DecodeBC1(src + 8, out, true);
+
+	unsigned char palette[8];
+	BC3AlphaPalette(src[0], src[1], palette);
+
+	unsigned long long indices = 0;
+	for (int i = 0; i < 6; ++i) {
+		indices |= (unsigned long long)src[2 + i] << (i * 8);
+	}
+	for (int i = 0; i < 16; ++i) {
+		out[i] = (out[i] & 0x00FFFFFF) | ((unsigned int)palette[(indices >> (i * 3)) & 7] << 24);
+	}
+}
+
+const Colour& Texture::CompressedTexel(int x, int y, int mipLevel) {
+	const Colour* data = GetLevel(mipLevel);
+
+	uint blocksWide = (GetWidth(mipLevel) + 3) >> 2;
+	uint block		= ((y >> 2) * blocksWide) + (x >> 2);
+	uint epoch		= texelCacheEpoch.load(std::memory_order_relaxed);
+
+	DecodedBlock &entry = texelCache[(block ^ ((size_t)data >> 6)) & (TEXEL_CACHE_SIZE - 1)];
+
+	if (entry.data != data || entry.block != block || entry.epoch != epoch) {
+		const unsigned char* src = (const unsigned char*)data;
+
+		if (format == TEXTURE_FORMAT_BC1) {
+			DecodeBC1(&src[block * 8], entry.texels, false);
+		}
+		else {
+			DecodeBC3(&src[block * 16], entry.texels);
+		}
+		entry.data	= data;
+		entry.block = block;
+		entry.epoch = epoch;
+	}
+	return (const Colour&)entry.texels[((y & 3) << 2) + (x & 3)];
 }
\ No newline at end of file
@@ -1,65 +1,174 @@
-#pragma once
-
-#include "SoftwareRasteriser.h"
-#include "Colour.h"
-
-#include <string>
-/******************************************************************************
-Class:Texture
-Implements:
-Author:Rich Davison	<richard.davison4@newcastle.ac.uk>
-Description:Simple class to hold texture data for our software rasteriser.
-
-Later on in the tutorial series, the ability to performa mipmapping and 
-bilinear filtering is added to this class.
-
-The provided TextureFromTGA function is very basic, and will only support
-uncompressed targa files - you can save images in this format using paint.net, 
-which is free
-
--_-_-_-_-_-_-_,------,   
-_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
--_-_-_-_-_-_-~|__( ^ .^) /
-_-_-_-_-_-_-_-""  ""   
-
-*//////////////////////////////////////////////////////////////////////////////
-#include <iostream>
-#include <fstream>
-#include <vector>
-
-using std::string;
-using std::ifstream;
-using std::vector;
-
-class Texture	{
-public:
-	friend class SoftwareRasteriser;
-	Texture(void);
-	~Texture(void);
-
-	static Texture* TextureFromTGA(const string &filename);
-	
-	const Colour&	NearestTexSample(const Vector3 &coords, int miplevel = 0);
-
-	const Colour&	ColourAtPoint(int x, int y, int mipLevel = 0) {
-		int texWidth  = width  >> mipLevel;
-		int texHeight = height >> mipLevel;
-
-		x = max(0,min(x,(int)texWidth-1));
-		y = max(0,min(y,(int)texHeight-1));
-
-		int index =  (y * texHeight) + x;
-
-		return texels[index];
-	}
-
-	uint	GetWidth()	{ return width;}
-	uint	GetHeight() { return height;}
-
-protected:
-	uint width;
-	uint height;
-
-	Colour* texels;
-};
-
+#pragma once
+
+#include "Common.h"
+#include "Vector3.h"
+#include "Colour.h"
+
+#include <string>
+/******************************************************************************
+Class:Texture
+Implements:
+Author:Rich Davison	<richard.davison4@newcastle.ac.uk>
+Description:Simple class to hold texture data for our software rasteriser.
+
+Later on in the tutorial series, the ability to performa mipmapping and 
+bilinear filtering is added to this class.
+
+TextureFromTGA supports 24 and 32 bit truecolour targa files, either
+uncompressed or RLE compressed - you can save images in this format using
+paint.net, which is free
+
+-_-_-_-_-_-_-_,------,   
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""   
+
+*//////////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+using std::string;
+using std::ifstream;
+using std::vector;
+
+//How many texels to blend together when sampling
+enum SampleState {
+	SAMPLE_NEAREST,		//Single texel, from the closest mip level
+	SAMPLE_BILINEAR,	//2x2 texels, from the closest mip level
+	SAMPLE_TRILINEAR	//2x2 texels from the two closest mip levels
+};
+
+//How the texels of each mip level are laid out in memory
+enum TextureLayout {
+	TEXTURE_LAYOUT_LINEAR,	//Row after row - easy to write into when uploading
+	TEXTURE_LAYOUT_TILED	//4x4 blocks of texels, so each block is one 64 byte cache line
+};
+
+//How the texels of each mip level are stored
+enum TextureFormat {
+	TEXTURE_FORMAT_RGBA8,	//A whole Colour per texel
+	TEXTURE_FORMAT_BC1,		//8 bytes per 4x4 block - two 565 colours, and 2 bit indices between them
+	TEXTURE_FORMAT_BC3		//16 bytes per 4x4 block - BC1 colour, plus 8 interpolated alpha values
+};
+
+//Enough for a 65536 x 65536 texture!
+static const uint MAX_MIP_LEVELS = 17;
+
+//Mip levels start on a cache line, so tiles don't straddle two of them
+static const uint TEXTURE_LEVEL_ALIGNMENT = 64;
+
+class TextureManager;
+
+class Texture	{
+public:
+	friend class SoftwareRasteriser;
+	friend class TextureManager;
+	friend class RenderTarget;
+	Texture(void);
+	~Texture(void);
+
+	static Texture* TextureFromTGA(const string &filename);
+
+	//Just reads the size out of the header, without touching the texels
+	static bool		TGADimensions(const string &filename, uint &width, uint &height);
+
+	//Fills in every level below 0 by averaging 2x2 blocks of the level above
+	void	GenerateMipMaps();
+
+	//Block compresses every level. Do this last, after mipmapping!
+	void	Compress(TextureFormat newFormat);
+
+	Colour			NearestTexSample(const Vector3 &coords, int miplevel = 0);
+	Colour			BilinearTexSample(const Vector3 &coords, int miplevel = 0);
+	Colour			TrilinearTexSample(const Vector3 &coords, float lod);
+
+	Colour			SampleTexture(const Vector3 &coords, float lod, SampleState state);
+
+	const Colour&	ColourAtPoint(int x, int y, int mipLevel = 0) {
+		int texWidth  = GetWidth(mipLevel);
+		int texHeight = GetHeight(mipLevel);
+
+		x = max(0,min(x,(int)texWidth-1));
+		y = max(0,min(y,(int)texHeight-1));
+
+		if (format != TEXTURE_FORMAT_RGBA8) {
+			//Only valid until the next sample of a compressed texture!
+			return CompressedTexel(x, y, mipLevel);
+		}
+		return GetLevel(mipLevel)[TexelIndex(layout, texWidth, x, y)];
+	}
+
+	//Managed textures might not have every level in memory - this pulls
+	//them in as they're needed
+	inline Colour* GetLevel(int mipLevel) {
+		if (!levels[mipLevel]) {
+			RequestLevel(mipLevel);
+		}
+		return levels[mipLevel];
+	}
+
+	bool	IsLevelResident(int mipLevel) { return levels[mipLevel] != NULL;}
+
+	//Rearranges the texels of every level into the new layout. Compressed
+	//textures are always in blocks, so this does nothing for them
+	void	SetLayout(TextureLayout newLayout);
+	TextureLayout GetLayout() { return layout;}
+
+	TextureFormat GetFormat() { return format;}
+
+	uint	GetWidth()	{ return width;}
+	uint	GetHeight() { return height;}
+
+	uint	GetWidth(int mipLevel)	{ return max(1u, width  >> mipLevel);}
+	uint	GetHeight(int mipLevel) { return max(1u, height >> mipLevel);}
+
+	uint	GetMipLevels() { return mipLevels;}
+
+	//How many texels a level takes up in the current layout
+	uint	LevelTexels(int mipLevel);
+	//How much memory a level takes up in the current layout and format
+	uint	LevelBytes(int mipLevel);
+
+protected:
+	static inline uint TexelIndex(TextureLayout l, uint levelWidth, uint x, uint y) {
+		if (l == TEXTURE_LAYOUT_TILED) {
+			uint tilesPerRow = (levelWidth + 3) >> 2;
+			uint tile = ((y >> 2) * tilesPerRow) + (x >> 2);
+
+			return (tile << 4) + ((y & 3) << 2) + (x & 3);
+		}
+		return (y * levelWidth) + x;
+	}
+
+	//How many levels it takes to get down to 1x1 from a given size
+	static uint	MipLevelsFor(uint width, uint height);
+
+	//Every level's memory comes from these, so it's properly aligned. New
+	//levels are filled with opaque black, like new Colour[] would be
+	static Colour*	NewLevel(uint bytes);
+	static void		DeleteLevel(Colour* texels);
+
+	void	AllocateLevels();
+	void	FreeLevel(int mipLevel);
+	void	RequestLevel(int mipLevel);
+	void	MarkUsed(int mipLevel);
+
+	const Colour&	CompressedTexel(int x, int y, int mipLevel);
+
+	TextureLayout layout;
+	TextureFormat format;
+
+	uint width;
+	uint height;
+
+	uint mipLevels;
+
+	//NULL if that level isn't in memory. Compressed levels are raw block data,
+	//kept in Colour sized chunks so that every format can be handled the same
+	Colour*	levels[MAX_MIP_LEVELS];
+	uint	levelLastUsed[MAX_MIP_LEVELS];	//Frame each level was last sampled on
+
+	TextureManager* manager;	//Only set if our levels can be streamed in and out
+};
+
@@ -0,0 +1,228 @@
+#include "TextureManager.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+
+/*
+Mip caches start with this header, followed by every level in tiled order.
+The source image's size and last write time are kept, so we can tell if the
+cache is stale - an edited image is often exactly the same size as before!
+*/
+struct MipCacheHeader {
+	char				id[4];
+	unsigned int		sourceBytes;
+	unsigned long long	sourceTime;
+	unsigned int		width;
+	unsigned int		height;
+	unsigned int		levels;
+	unsigned int		format;
+};
+
+//Both are left as 0 if the file isn't there
+static void FileStamp(const string &filename, unsigned int &bytes, unsigned long long &time) {
+	bytes	= 0;
+	time	= 0;
+
+	struct stat info;
+	if (stat(filename.c_str(), &info) == 0) {
+		bytes	= (unsigned int)info.st_size;
+		time	= (unsigned long long)info.st_mtime;
+	}
+}
+
+TextureManager::TextureManager(size_t budgetBytes)	{
+	frame = 1;	//0 means 'never used'
+
+	memset(&stats, 0, sizeof(stats));
+	stats.budgetBytes = budgetBytes;
+}
+
+TextureManager::~TextureManager(void)	{
+	for (map<string, Texture*>::iterator i = textures.begin(); i != textures.end(); ++i) {
+		delete i->second;
+	}
+}
+
+Texture* TextureManager::GetTexture(const string &filename, TextureFormat format) {
+	map<string, Texture*>::iterator i = textures.find(filename);
+	if (i != textures.end()) {
+		return i->second;
+	}
+
+	uint width	= 0;
+	uint height = 0;
+
+	if (!Texture::TGADimensions(filename, width, height) || width == 0 || height == 0) {
+		return NULL;
+	}
+
+	Texture* t		= new Texture();
+	t->width		= width;
+	t->height		= height;
+	t->mipLevels	= Texture::MipLevelsFor(width, height);
+	t->layout		= TEXTURE_LAYOUT_TILED;
+	t->format		= format;
+	t->manager		= this;
+
+	ManagedTexture m;
+	m.source		= filename;
+	m.cacheFile		= filename + ".mipcache";
+	m.cacheReady	= false;
+
+	size_t offset = sizeof(MipCacheHeader);
+	for (uint level = 0; level < t->mipLevels; ++level) {
+		m.levelOffsets[level] = offset;
+		offset += t->LevelBytes(level);
+	}
+
+	//If there's already an up to date cache from a previous run, use it
+	std::ifstream cache(m.cacheFile.c_str(), std::ios::binary);
+	if (cache.is_open()) {
+		unsigned int		sourceBytes;
+		unsigned long long	sourceTime;
+		FileStamp(filename, sourceBytes, sourceTime);
+
+		MipCacheHeader h;
+		if (cache.read((char*)&h, sizeof(h)) &&
+			memcmp(h.id, "MIPC", 4) == 0 &&
+			h.sourceBytes == sourceBytes && h.sourceTime == sourceTime &&
+			h.width == width && h.height == height && h.levels == t->mipLevels && h.format == format) {
+			m.cacheReady = true;
+		}
+	}
+
+	textures.insert(std::make_pair(filename, t));
+	managed.insert(std::make_pair(t, m));
+
+	stats.textures++;
+	stats.totalLevels += t->mipLevels;
+
+	return t;
+}
+
+void TextureManager::SetBudget(size_t bytes) {
+	stats.budgetBytes = bytes;
+
+	if (stats.residentBytes > bytes) {
+		MakeRoom(0);
+	}
+}
+
+void TextureManager::LoadLevel(Texture* t, int mipLevel) {
+	ManagedTexture &m = managed[t];
+
+	MakeRoom(t->LevelBytes(mipLevel));
+
+	bool loaded = false;
+
+	if (m.cacheReady) {
+		loaded = ReadLevelFromCache(t, m, mipLevel);
+	}
+	if (!loaded) {
+		loaded = BuildCache(t, m, mipLevel);
+	}
+	if (!loaded) {
+		//Missing or broken source image. Leave a blank level behind
+		//rather than trying (and failing) to load it on every sample
+		t->levels[mipLevel] = Texture::NewLevel(t->LevelBytes(mipLevel));
+	}
+	t->levelLastUsed[mipLevel] = frame;
+
+	AddResident(t, mipLevel);
+	stats.levelLoads++;
+}
+
+bool TextureManager::ReadLevelFromCache(Texture* t, ManagedTexture &m, int mipLevel) {
+	std::ifstream cache(m.cacheFile.c_str(), std::ios::binary);
+	if (!cache.is_open()) {
+		m.cacheReady = false;
+		return false;
+	}
+	Colour* texels = Texture::NewLevel(t->LevelBytes(mipLevel));
+
+	cache.seekg(m.levelOffsets[mipLevel]);
+	if (!cache.read((char*)texels, t->LevelBytes(mipLevel))) {
+		Texture::DeleteLevel(texels);
+		m.cacheReady = false;
+		return false;
+	}
+	t->levels[mipLevel] = texels;
+	return true;
+}
+
+bool TextureManager::BuildCache(Texture* t, ManagedTexture &m, int keepLevel) {
+	Texture* full = Texture::TextureFromTGA(m.source);
+
+	if (!full || full->width != t->width || full->height != t->height) {
+		delete full;
+		return false;
+	}
+	stats.cacheBuilds++;
+
+	full->Compress(t->format);
+
+	std::ofstream cache(m.cacheFile.c_str(), std::ios::binary);
+	if (cache.is_open()) {
+		MipCacheHeader h;
+		memset(&h, 0, sizeof(h));
+		memcpy(h.id, "MIPC", 4);
+		FileStamp(m.source, h.sourceBytes, h.sourceTime);
+		h.width			= t->width;
+		h.height		= t->height;
+		h.levels		= t->mipLevels;
+		h.format		= t->format;
+
+		cache.write((char*)&h, sizeof(h));
+
+		for (uint level = 0; level < t->mipLevels; ++level) {
+			cache.write((char*)full->levels[level], full->LevelBytes(level));
+		}
+		//If it didn't write (read only asset folder?), we'll just decode the
+		//source image again next time a level is needed
+		m.cacheReady = !cache.fail();
+	}
+	//We've got the level we wanted in memory anyway, so steal it
+	t->levels[keepLevel]	 = full->levels[keepLevel];
+	full->levels[keepLevel] = NULL;
+
+	delete full;
+	return true;
+}
+
+void TextureManager::MakeRoom(size_t bytes) {
+	while (stats.residentBytes + bytes > stats.budgetBytes) {
+		Texture*	oldest		= NULL;
+		int			oldestLevel = 0;
+		uint		oldestFrame = frame;
+
+		for (map<Texture*, ManagedTexture>::iterator i = managed.begin(); i != managed.end(); ++i) {
+			Texture* t = i->first;
+			for (uint level = 0; level < t->mipLevels; ++level) {
+				if (t->levels[level] && t->levelLastUsed[level] < oldestFrame) {
+					oldest		= t;
+					oldestLevel = level;
+					oldestFrame = t->levelLastUsed[level];
+				}
+			}
+		}
+		if (!oldest) {
+			return; //Everything left is in use this frame
+		}
+		RemoveResident(oldest, oldestLevel);
+
+		oldest->FreeLevel(oldestLevel);
+
+		stats.levelEvictions++;
+	}
+}
+
+void TextureManager::AddResident(Texture* t, int mipLevel) {
+	stats.residentBytes += t->LevelBytes(mipLevel);
+	stats.residentLevels++;
+
+	stats.peakResidentBytes = max(stats.peakResidentBytes, stats.residentBytes);
+}
+
+void TextureManager::RemoveResident(Texture* t, int mipLevel) {
+	stats.residentBytes -= t->LevelBytes(mipLevel);
+	stats.residentLevels--;
+}
@@ -0,0 +1,90 @@
+/******************************************************************************
+Class:TextureManager
+Implements:
+Description:Owns every Texture loaded through it, and keeps the texels they use
+under a memory budget. Textures start off with nothing but their size - each
+mip level is streamed in from disk the first time something samples it, and
+the least recently used levels are thrown away again when we go over budget.
+
+The first time a level is needed, the whole source image is decoded and
+mipmapped as normal, and the tiled levels are written out to a '.mipcache'
+file alongside it. After that, each level can be read straight back from its
+own spot in the cache, without ever having to decode the rest.
+
+Call NextFrame once per frame, so that we know what's 'recently' used!
+
+-_-_-_-_-_-_-_,------,   
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""   
+
+*//////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Texture.h"
+
+#include <map>
+#include <string>
+
+using std::map;
+using std::string;
+
+struct TextureResidencyStats {
+	size_t	budgetBytes;
+	size_t	residentBytes;
+	size_t	peakResidentBytes;
+
+	uint	textures;
+	uint	totalLevels;
+	uint	residentLevels;
+
+	uint	levelLoads;		//Every level brought in, from the cache or the source image
+	uint	levelEvictions;
+	uint	cacheBuilds;	//How many times we've had to decode a whole source image
+};
+
+class TextureManager	{
+public:
+	friend class Texture;
+
+	TextureManager(size_t budgetBytes);
+	~TextureManager(void);
+
+	//Hands back the same Texture each time it's asked for the same file.
+	//None of its levels are loaded until they're sampled.
+	Texture*	GetTexture(const string &filename, TextureFormat format = TEXTURE_FORMAT_RGBA8);
+
+	void		SetBudget(size_t bytes);
+	size_t		GetBudget() { return stats.budgetBytes;}
+
+	void		NextFrame() { frame++;}
+	uint		GetFrame()	{ return frame;}
+
+	const TextureResidencyStats& GetStats() { return stats;}
+
+protected:
+	struct ManagedTexture {
+		string	source;
+		string	cacheFile;
+		bool	cacheReady;
+		size_t	levelOffsets[MAX_MIP_LEVELS];	//Byte offsets into the cache file
+	};
+
+	void	LoadLevel(Texture* t, int mipLevel);
+	bool	BuildCache(Texture* t, ManagedTexture &m, int keepLevel);
+	bool	ReadLevelFromCache(Texture* t, ManagedTexture &m, int mipLevel);
+
+	//Frees the least recently used levels until 'bytes' more will fit. Levels
+	//used this frame are never thrown away, so we may still end up over budget
+	void	MakeRoom(size_t bytes);
+
+	void	AddResident(Texture* t, int mipLevel);
+	void	RemoveResident(Texture* t, int mipLevel);
+
+	map<string, Texture*>			textures;
+	map<Texture*, ManagedTexture>	managed;
+
+	uint	frame;
+
+	TextureResidencyStats stats;
+};
@@ -1,153 +1,153 @@
-/******************************************************************************
-Class:Vector3
-Implements:
-Author:Rich Davison	<richard.davison4@newcastle.ac.uk>
-Description:Simple 3-component vector class, with associated math overloads
-
--_-_-_-_-_-_-_,------,   
-_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
--_-_-_-_-_-_-~|__( ^ .^) /
-_-_-_-_-_-_-_-""  ""   
-
-*//////////////////////////////////////////////////////////////////////////////
-#pragma once
-#include <cmath>
-#include <iostream>
-
-#include "Vector4.h"
-#include "Vector2.h"
-
-class Vector4;
-class Vector2;
-
-class Vector3	{
-public:
-	Vector3(void) {
-		ToZero();
-	}
-
-	Vector3(const float x, const float y, const float z) {
-		this->x = x;
-		this->y = y;
-		this->z = z;
-	}
-
-	Vector3(const float size) {
-		this->x = size;
-		this->y = size;
-		this->z = size;
-	}
-
-	~Vector3(void){}
-
-	float x;
-	float y;
-	float z;
-
-	void			Normalise() {
-		float length = Length();
-
-		if(length != 0.0f)	{
-			length = 1.0f / length;
-			x = x * length;
-			y = y * length;
-			z = z * length;
-		}
-	}
-
-	void		ToZero() {
-		x = y = z = 0.0f;
-	}
-
-	float			Length() const {
-		return sqrt((x*x)+(y*y)+(z*z));	
-	}
-
-	float			LengthSquared() const {
-		return (x*x)+(y*y)+(z*z);	
-	}
-
-	void			Invert() {
-		x = -x;
-		y = -y;	
-		z = -z;	
-	}
-
-	Vector3			Inverse() const{
-		return Vector3(-x,-y,-z);
-	}
-
-	static inline float	Dot(const Vector3 &a, const Vector3 &b) {
-		return (a.x*b.x)+(a.y*b.y)+(a.z*b.z);
-	}
-
-	static inline Vector3	Cross(const Vector3 &a, const Vector3 &b) {
-		return Vector3((a.y*b.z) - (a.z*b.y) , (a.z*b.x) - (a.x*b.z) , (a.x*b.y) - (a.y*b.x));	
-	}
-
-	inline friend std::ostream& operator<<(std::ostream& o, const Vector3& v) {
-		o << "Vector3(" << v.x << "," << v.y << "," << v.z <<")" << std::endl;
-		return o;
-	}
-
-	inline Vector3  operator+(const Vector3  &a) const{
-		return Vector3(x + a.x,y + a.y, z + a.z);
-	}
-
-	inline Vector3  operator-(const Vector3  &a) const{
-		return Vector3(x - a.x,y - a.y, z - a.z);
-	}
-
-	inline Vector3  operator-() const{
-		return Vector3(-x,-y,-z);
-	}
-
-	inline void operator+=(const Vector3  &a){
-		x += a.x;
-		y += a.y;
-		z += a.z;
-	}
-
-	inline void operator-=(const Vector3  &a){
-		x -= a.x;
-		y -= a.y;
-		z -= a.z;
-	}
-
-	inline void operator/=(const Vector3  &a){
-		x /= a.x;
-		y /= a.y;
-		z /= a.z;
-	}
-
-	inline Vector3  operator*(const float a) const{
-		return Vector3(x * a,y * a, z * a);
-	}
-
-	inline Vector3  operator*(const Vector3  &a) const{
-		return Vector3(x * a.x,y * a.y, z * a.z);
-	}
-
-	inline Vector3  operator/(const Vector3  &a) const{
-		return Vector3(x / a.x,y / a.y, z / a.z);
-	};
-
-	inline Vector3  operator/(const float v) const{
-		return Vector3(x / v,y / v, z / v);
-	};
-
-	float GetMaxElement();
-
-	float GetMinElement();
-
-	static inline Vector3 Lerp(const Vector3 &a, const Vector3 &b, float by) {
-		return (a*(1.0f-by)) + (b * by);
-	}
-
-	Vector4 ToVector4(float w = 0.0f);
-	Vector2 ToVector2();
-
-	inline bool	operator==(const Vector3 &A)const {return (A.x == x && A.y == y && A.z == z) ? true : false;};
-	inline bool	operator!=(const Vector3 &A)const {return (A.x == x && A.y == y && A.z == z) ? false : true;};
-};
-
+/******************************************************************************
+Class:Vector3
+Implements:
+Author:Rich Davison	<richard.davison4@newcastle.ac.uk>
+Description:Simple 3-component vector class, with associated math overloads
+
+-_-_-_-_-_-_-_,------,   
+_-_-_-_-_-_-_-|   /\_/\   NYANYANYAN
+-_-_-_-_-_-_-~|__( ^ .^) /
+_-_-_-_-_-_-_-""  ""   
+
+*//////////////////////////////////////////////////////////////////////////////
+#pragma once
+#include <cmath>
+#include <iostream>
+
+#include "Vector4.h"
+#include "Vector2.h"
+
+class Vector4;
+class Vector2;
+
+class Vector3	{
+public:
+	Vector3(void) {
+		ToZero();
+	}
+
+	Vector3(const float x, const float y, const float z) {
+		this->x = x;
+		this->y = y;
+		this->z = z;
+	}
+
+	Vector3(const float size) {
+		this->x = size;
+		this->y = size;
+		this->z = size;
+	}
+
+	~Vector3(void){}
+
+	float x;
+	float y;
+	float z;
+
+	void			Normalise() {
+		float length = Length();
+
+		if(length != 0.0f)	{
+			length = 1.0f / length;
+			x = x * length;
+			y = y * length;
+			z = z * length;
+		}
+	}
+
+	void		ToZero() {
+		x = y = z = 0.0f;
+	}
+
+	float			Length() const {
+		return sqrt((x*x)+(y*y)+(z*z));	
+	}
+
+	float			LengthSquared() const {
+		return (x*x)+(y*y)+(z*z);	
+	}
+
+	void			Invert() {
+		x = -x;
+		y = -y;	
+		z = -z;	
+	}
+
+	Vector3			Inverse() const{
+		return Vector3(-x,-y,-z);
+	}
+
+	static inline float	Dot(const Vector3 &a, const Vector3 &b) {
+		return (a.x*b.x)+(a.y*b.y)+(a.z*b.z);
+	}
+
+	static inline Vector3	Cross(const Vector3 &a, const Vector3 &b) {
+		return Vector3((a.y*b.z) - (a.z*b.y) , (a.z*b.x) - (a.x*b.z) , (a.x*b.y) - (a.y*b.x));	
+	}
+
+	inline friend std::ostream& operator<<(std::ostream& o, const Vector3& v) {
+		o << "Vector3(" << v.x << "," << v.y << "," << v.z <<")" << std::endl;
+		return o;
+	}
+
+	inline Vector3  operator+(const Vector3  &a) const{
+		return Vector3(x + a.x,y + a.y, z + a.z);
+	}
+
+	inline Vector3  operator-(const Vector3  &a) const{
+		return Vector3(x - a.x,y - a.y, z - a.z);
+	}
+
+	inline Vector3  operator-() const{
+		return Vector3(-x,-y,-z);
+	}
+
+	inline void operator+=(const Vector3  &a){
+		x += a.x;
+		y += a.y;
+		z += a.z;
+	}
+
+	inline void operator-=(const Vector3  &a){
+		x -= a.x;
+		y -= a.y;
+		z -= a.z;
+	}
+
+	inline void operator/=(const Vector3  &a){
+		x /= a.x;
+		y /= a.y;
+		z /= a.z;
+	}
+
+	inline Vector3  operator*(const float a) const{
+		return Vector3(x * a,y * a, z * a);
+	}
+
+	inline Vector3  operator*(const Vector3  &a) const{
+		return Vector3(x * a.x,y * a.y, z * a.z);
+	}
+
+	inline Vector3  operator/(const Vector3  &a) const{
+		return Vector3(x / a.x,y / a.y, z / a.z);
+	};
+
+	inline Vector3  operator/(const float v) const{
+		return Vector3(x / v,y / v, z / v);
+	};
+
+	float GetMaxElement();
+
+	float GetMinElement();
+
+	static inline Vector3 Lerp(const Vector3 &a, const Vector3 &b, float by) {
+		return (a*(1.0f-by)) + (b * by);
+	}
+
+	Vector4 ToVector4(float w = 0.0f);
+	Vector2 ToVector2();
+
+	inline bool	operator==(const Vector3 &A)const {return (A.x == x && A.y == y && A.z == z) ? true : false;};
+	inline bool	operator!=(const Vector3 &A)const {return (A.x == x && A.y == y && A.z == z) ? false : true;};
+};
+